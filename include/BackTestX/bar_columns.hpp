@@ -0,0 +1,77 @@
+#ifndef BAR_COLUMNS_HPP
+#define BAR_COLUMNS_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace backtestx {
+
+// Column store of OHLCV bars, one contiguous vector per field
+struct BarColumns {
+  std::vector<double> dates;
+  std::vector<double> closes;
+  std::vector<int> volumes;
+  std::vector<double> opens;
+  std::vector<double> highs;
+  std::vector<double> lows;
+
+  std::size_t size() const { return dates.size(); }
+  bool empty() const { return dates.empty(); }
+
+  void reserve(std::size_t n) {
+    dates.reserve(n);
+    closes.reserve(n);
+    volumes.reserve(n);
+    opens.reserve(n);
+    highs.reserve(n);
+    lows.reserve(n);
+  }
+
+  void resize(std::size_t n) {
+    dates.resize(n);
+    closes.resize(n);
+    volumes.resize(n);
+    opens.resize(n);
+    highs.resize(n);
+    lows.resize(n);
+  }
+
+  void clear() {
+    dates.clear();
+    closes.clear();
+    volumes.clear();
+    opens.clear();
+    highs.clear();
+    lows.clear();
+  }
+
+  void Append(double date, double close, int volume, double open, double high,
+              double low) {
+    dates.push_back(date);
+    closes.push_back(close);
+    volumes.push_back(volume);
+    opens.push_back(open);
+    highs.push_back(high);
+    lows.push_back(low);
+  }
+
+  // Append bars [from, to) of another column store
+  void Append(const BarColumns &other, std::size_t from, std::size_t to) {
+    dates.insert(dates.end(), other.dates.begin() + from,
+                 other.dates.begin() + to);
+    closes.insert(closes.end(), other.closes.begin() + from,
+                  other.closes.begin() + to);
+    volumes.insert(volumes.end(), other.volumes.begin() + from,
+                   other.volumes.begin() + to);
+    opens.insert(opens.end(), other.opens.begin() + from,
+                 other.opens.begin() + to);
+    highs.insert(highs.end(), other.highs.begin() + from,
+                 other.highs.begin() + to);
+    lows.insert(lows.end(), other.lows.begin() + from,
+                other.lows.begin() + to);
+  }
+};
+
+}  // namespace backtestx
+
+#endif /* BAR_COLUMNS_HPP */
@@ -0,0 +1,54 @@
+#ifndef BOOK_BOOK_STORE_HPP
+#define BOOK_BOOK_STORE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "BackTestX/book/order_book.hpp"
+
+namespace backtestx {
+namespace book {
+
+// Order books of all symbols, fed from book messages on the subscriber
+// thread and read by the GUI. A book is only updated once a snapshot of it has
+// been received; when an update is missing, the book is cleared and its
+// updates are dropped until the next snapshot.
+class BookStore {
+ public:
+  BookStore();
+
+  // Apply a binary book update or snapshot message. Returns false if the
+  // message is not a valid book message.
+  bool ProcessMessage(const std::uint8_t* data, std::size_t length);
+
+  std::vector<std::uint32_t> GetSymbols();
+
+  // Copy up to levels levels of each side of a symbol's book, best first
+  bool GetDepth(std::uint32_t symbol_id, std::size_t levels,
+                std::vector<BookLevel>& bids, std::vector<BookLevel>& asks);
+
+ private:
+  std::mutex data_mutex_;
+  struct SymbolBook {
+    OrderBook book;
+    bool synced = false;
+    std::uint32_t next_sequence = 0;
+  };
+
+  std::unordered_map<std::uint32_t, std::unique_ptr<SymbolBook>> books_;
+
+  // Consecutive updates usually target the same symbol
+  std::uint32_t last_symbol_id_;
+  SymbolBook* last_book_;
+
+  SymbolBook& BookFor(std::uint32_t symbol_id);
+};
+
+}  // namespace book
+}  // namespace backtestx
+
+#endif /* BOOK_BOOK_STORE_HPP */
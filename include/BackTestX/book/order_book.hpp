@@ -0,0 +1,96 @@
+#ifndef BOOK_ORDER_BOOK_HPP
+#define BOOK_ORDER_BOOK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "BackTestX/message/book_message.hpp"
+
+namespace backtestx {
+namespace book {
+
+using message::BookLevel;
+using message::Side;
+
+// Price-level order book stored in flat arrays indexed by the tick offset from
+// a base price. Each side keeps a quantity per tick and a bitmap of occupied
+// ticks, so updates are O(1) and the next best level is found by scanning
+// bitmap words rather than walking a tree. The window is anchored on the
+// touch: levels outside it, such as far away stub quotes, are kept in a small
+// ordered map per side, and the window is only recentred when the best bid or
+// ask itself moves out of it. No level is ever lost.
+class OrderBook {
+ public:
+  static const std::size_t DEFAULT_WINDOW_TICKS = 1 << 14;
+
+  explicit OrderBook(std::size_t window_ticks = DEFAULT_WINDOW_TICKS);
+
+  void Apply(message::BookAction action, Side side, std::int64_t price_ticks,
+             std::int64_t quantity);
+
+  // Set the quantity of a level, removing it when the quantity is not positive
+  void SetLevel(Side side, std::int64_t price_ticks, std::int64_t quantity);
+
+  void Clear();
+
+  bool BestBid(BookLevel& level) const;
+  bool BestAsk(BookLevel& level) const;
+
+  std::int64_t Quantity(Side side, std::int64_t price_ticks) const;
+
+  // Copy up to max_levels levels from the top of a side into out, best first
+  std::size_t Depth(Side side, std::size_t max_levels,
+                    std::vector<BookLevel>& out) const;
+
+  std::size_t LevelCount(Side side) const;
+
+  // Levels currently kept outside the window
+  std::size_t OverflowLevels() const {
+    return bids_.overflow.size() + asks_.overflow.size();
+  }
+
+ private:
+  struct SideBook {
+    std::vector<std::int64_t> quantity;
+    std::vector<std::uint64_t> occupied;
+    std::int64_t best = -1;  // index of the best level, -1 when empty
+    std::size_t count = 0;    // levels in the window
+    std::map<std::int64_t, std::int64_t> overflow;  // price -> quantity
+  };
+
+  std::size_t window_;
+  std::int64_t base_;
+  SideBook bids_;
+  SideBook asks_;
+
+  SideBook& Book(Side side) { return side == Side::kBid ? bids_ : asks_; }
+  const SideBook& Book(Side side) const {
+    return side == Side::kBid ? bids_ : asks_;
+  }
+
+  bool InWindow(std::int64_t price_ticks) const {
+    return static_cast<std::uint64_t>(price_ticks - base_) < window_;
+  }
+
+  bool Best(Side side, BookLevel& level) const;
+
+  // Whether the best level of a side lies outside the window
+  bool TouchOutside(Side side) const;
+
+  // Move the window onto the touch if the best bid or ask lies outside it
+  void Recenter();
+  void SetIndex(Side side, std::int64_t index, std::int64_t quantity);
+  void ClearWindow(SideBook& book);
+
+  // Highest occupied index <= from, or -1
+  static std::int64_t FindPrevious(const SideBook& book, std::int64_t from);
+  // Lowest occupied index >= from, or -1
+  static std::int64_t FindNext(const SideBook& book, std::int64_t from);
+};
+
+}  // namespace book
+}  // namespace backtestx
+
+#endif /* BOOK_ORDER_BOOK_HPP */
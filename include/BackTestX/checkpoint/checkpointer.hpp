@@ -0,0 +1,85 @@
+#ifndef CHECKPOINT_CHECKPOINTER_HPP
+#define CHECKPOINT_CHECKPOINTER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "BackTestX/bar_columns.hpp"
+#include "BackTestX/plot/data_handler.hpp"
+
+namespace backtestx {
+namespace checkpoint {
+
+static const std::uint32_t SNAPSHOT_MAGIC = 0x53585442;  // "BTXS"
+static const std::uint32_t SNAPSHOT_VERSION = 2;
+
+// Binary snapshot layout: the header followed by the date, close, open, high
+// and low columns as doubles and the volume column as 32-bit integers.
+struct alignas(64) SnapshotHeader {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint64_t bar_count;
+  std::uint64_t next_row;  // source row index following the last bar
+  std::int64_t created_ms;
+};
+
+// Write a snapshot atomically by writing a temporary file and renaming it
+void WriteSnapshot(const std::string& path, const BarColumns& bars,
+                   std::uint64_t next_row);
+
+// Map a snapshot and load it into bars. Returns false if there is no valid
+// snapshot at path.
+bool ReadSnapshot(const std::string& path, BarColumns& bars,
+                  std::uint64_t& next_row);
+
+// Periodically writes the bars of a DataHandler to a snapshot file on a
+// background thread. Only bars added since the previous checkpoint are copied
+// under the handler's lock, so ProcessData is never held up by disk I/O.
+class Checkpointer {
+ public:
+  Checkpointer(std::shared_ptr<plot::DataHandler> data_handler,
+               const std::string& path, std::chrono::milliseconds interval);
+  ~Checkpointer();
+
+  // Do not allow copy
+  Checkpointer(const Checkpointer&) = delete;
+  Checkpointer& operator=(const Checkpointer&) = delete;
+
+  // Load the latest snapshot into the data handler. Returns the number of
+  // restored bars and sets next_row to the source row to resume from.
+  std::size_t Restore(std::uint64_t& next_row);
+
+  void Start();
+
+  // Stop the background thread after writing a final checkpoint
+  void Stop();
+
+ private:
+  std::shared_ptr<plot::DataHandler> data_handler_;
+  std::string path_;
+  std::chrono::milliseconds interval_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_requested_;
+  std::thread thread_;
+
+  // Copy of the bars already checkpointed, owned by the background thread
+  BarColumns bars_;
+  std::uint64_t next_row_;
+  std::size_t written_count_;
+
+  void CheckpointThread();
+  void Checkpoint();
+};
+
+}  // namespace checkpoint
+}  // namespace backtestx
+
+#endif /* CHECKPOINT_CHECKPOINTER_HPP */
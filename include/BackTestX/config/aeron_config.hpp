@@ -11,6 +11,11 @@ const static std::string DEFAULT_CHANNEL = "aeron:udp?endpoint=localhost:20121";
 const static std::int32_t DEFAULT_STREAM_ID = 1001;
 const static int DEFAULT_LINGER_TIMEOUT_MS = 0;
 const static int DEFAULT_POLL_TIMEOUT_MS = 1;
+const static double DEFAULT_TICK_SIZE = 0.01;
+const static int DEFAULT_BAR_BATCH_SIZE = 64;
+const static int DEFAULT_PRICE_DECIMALS = 4;
+const static int DEFAULT_KEYFRAME_INTERVAL = 16;
+const static int DEFAULT_SNAPSHOT_INTERVAL = 1000;
 
 }  // namespace configuration
 }  // namespace backtestx
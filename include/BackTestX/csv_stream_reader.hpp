@@ -0,0 +1,111 @@
+#ifndef CSV_STREAM_READER_HPP
+#define CSV_STREAM_READER_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace backtestx {
+
+// Reads a CSV file incrementally into fixed-size chunks of rows, so memory
+// use does not depend on the size of the file
+class CsvStreamReader {
+ public:
+  // Raw text of a block of rows together with the offsets of every cell.
+  // Chunks are reused, so their storage only grows up to the largest chunk.
+  struct Chunk {
+    std::string text;
+    std::vector<std::uint32_t> offsets;  // begin/end of each cell
+    std::size_t rows = 0;
+    std::size_t columns = 0;
+
+    std::string_view Cell(std::size_t row, std::size_t column) const {
+      const std::size_t i = 2 * (row * columns + column);
+      return std::string_view(text.data() + offsets[i],
+                              offsets[i + 1] - offsets[i]);
+    }
+
+    void Clear() {
+      text.clear();
+      offsets.clear();
+      rows = 0;
+    }
+  };
+
+  CsvStreamReader();
+
+  // Do not allow copy
+  CsvStreamReader(const CsvStreamReader &) = delete;
+  CsvStreamReader &operator=(const CsvStreamReader &) = delete;
+
+  // Open the file and read its header line
+  bool Open(const std::string &filename);
+
+  const std::vector<std::string> &Headers() const { return headers_; }
+
+  // Index of a column by its header, or -1 if there is no such column
+  int ColumnIndex(const std::string &header) const;
+
+  // Parse up to max_rows rows into chunk. Returns the number of rows read,
+  // which is 0 at the end of the file.
+  std::size_t ReadChunk(Chunk &chunk, std::size_t max_rows);
+
+ private:
+  std::ifstream file_;
+  std::vector<std::string> headers_;
+  std::string line_;
+};
+
+// Runs a CsvStreamReader on a background thread, parsing chunks ahead into a
+// small pool of reusable buffers while the consumer works on earlier ones
+class ReadAheadReader {
+ public:
+  ReadAheadReader(std::size_t chunk_rows, std::size_t chunk_count);
+  ~ReadAheadReader();
+
+  // Do not allow copy
+  ReadAheadReader(const ReadAheadReader &) = delete;
+  ReadAheadReader &operator=(const ReadAheadReader &) = delete;
+
+  // Open the file on the calling thread so errors surface immediately
+  bool Open(const std::string &filename);
+
+  const CsvStreamReader &Reader() const { return reader_; }
+
+  void Start();
+
+  // Next parsed chunk in file order, blocking while the reader is behind.
+  // Returns nullptr once the whole file has been consumed.
+  CsvStreamReader::Chunk *Acquire();
+
+  // Hand a consumed chunk back to the reader
+  void Release(CsvStreamReader::Chunk *chunk);
+
+  void Stop();
+
+ private:
+  CsvStreamReader reader_;
+  std::size_t chunk_rows_;
+  std::vector<std::unique_ptr<CsvStreamReader::Chunk>> chunks_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<CsvStreamReader::Chunk *> free_;
+  std::deque<CsvStreamReader::Chunk *> filled_;
+  bool end_of_file_;
+  bool stop_requested_;
+  std::thread thread_;
+
+  void ReaderThread();
+};
+
+}  // namespace backtestx
+
+#endif /* CSV_STREAM_READER_HPP */
@@ -11,6 +11,7 @@
 #include "imgui_impl_opengl3.h"
 #include <GLFW/glfw3.h>
 
+#include "BackTestX/book/book_store.hpp"
 #include "BackTestX/plot/data_handler.hpp"
 
 namespace backtestx {
@@ -30,11 +31,14 @@ class GUI {
 
   void SetDataHandler(std::shared_ptr<plot::DataHandler> data_handler);
 
+  void SetBookStore(std::shared_ptr<book::BookStore> book_store);
+
  private:
   std::atomic_bool keep_running_;
   std::thread gui_thread_;
 
   std::shared_ptr<plot::DataHandler> data_handler_;
+  std::shared_ptr<book::BookStore> book_store_;
 
   void GUIThread();
 };
@@ -0,0 +1,127 @@
+#ifndef MESSAGE_BAR_BATCH_HPP
+#define MESSAGE_BAR_BATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "BackTestX/bar_columns.hpp"
+#include "BackTestX/message/book_message.hpp"
+
+namespace backtestx {
+namespace message {
+
+// Compressed batch of consecutive bars of one symbol. The header is followed
+// by bar_count bars of six zigzag varints each:
+//
+//   date   - previous date (seconds)
+//   close  - previous close (ticks)
+//   volume - previous volume
+//   open   - close (ticks)
+//   high   - close (ticks)
+//   low    - close (ticks)
+//
+// "Previous" refers to the last bar of the symbol, carried over from batch to
+// batch. Keyframes start from zero instead, so they decode on their own and
+// let a late joiner, or a subscriber that missed a batch, get back in sync.
+struct BarBatchHeader {
+  std::uint8_t type;
+  std::uint8_t flags;
+  std::uint16_t bar_count;
+  std::uint32_t symbol_id;
+  std::uint32_t sequence;        // per symbol, incremented for every batch
+  std::uint32_t ticks_per_unit;  // price = ticks / ticks_per_unit
+  std::uint64_t last_row;        // source row index of the last bar
+};
+
+static_assert(sizeof(BarBatchHeader) == 24, "Unexpected padding");
+
+static const std::uint8_t BAR_BATCH_KEYFRAME = 0x01;
+
+// Longest encoding of a 64-bit varint
+static const std::size_t MAX_VARINT_LENGTH = 10;
+static const std::size_t BAR_BATCH_FIELDS = 6;
+
+inline std::uint64_t ZigZagEncode(std::int64_t value) {
+  return (static_cast<std::uint64_t>(value) << 1) ^
+         static_cast<std::uint64_t>(value >> 63);
+}
+
+inline std::int64_t ZigZagDecode(std::uint64_t value) {
+  return static_cast<std::int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+// Packs the bars of one symbol into batch messages
+class BarBatchEncoder {
+ public:
+  BarBatchEncoder(std::uint32_t symbol_id, std::size_t batch_size,
+                  int price_decimals, std::size_t keyframe_interval);
+
+  // Upper bound of the length of a message
+  std::size_t MaxLength() const;
+
+  // Add the bar of source row row to the current batch. Returns true when
+  // the batch is full and should be written out with Finish.
+  bool Add(double date, double close, std::int64_t volume, double open,
+           double high, double low, std::uint64_t row);
+
+  std::size_t Count() const { return count_; }
+
+  // Write the current batch as a message into out, which must hold
+  // MaxLength() bytes, and start a new batch. Returns the message length, or
+  // 0 if the batch is empty.
+  std::size_t Finish(std::uint8_t* out);
+
+ private:
+  std::uint32_t symbol_id_;
+  std::size_t batch_size_;
+  double ticks_per_unit_;
+  std::size_t keyframe_interval_;
+
+  std::uint32_t sequence_;
+  std::size_t count_;
+  std::vector<std::uint8_t> body_;
+  std::size_t body_length_;
+  std::uint64_t last_row_;
+
+  std::int64_t date_;
+  std::int64_t close_;
+  std::int64_t volume_;
+
+  bool IsKeyframe() const { return sequence_ % keyframe_interval_ == 0; }
+  void Put(std::int64_t delta);
+};
+
+// Decodes batch messages of any number of symbols, tracking the sequence of
+// each. Until a symbol has seen a keyframe, and again after a missing or
+// malformed batch, its batches are dropped since their deltas have no base.
+class BarBatchDecoder {
+ public:
+  BarBatchDecoder();
+
+  // Decode a message and append its bars to bars. Returns the number of bars
+  // appended, 0 if the batch was dropped.
+  std::size_t Decode(const std::uint8_t* data, std::size_t length,
+                     BarColumns& bars);
+
+  // Batches dropped while out of sync, or because they were malformed
+  std::uint64_t DroppedBatches() const { return dropped_batches_; }
+
+ private:
+  struct SymbolState {
+    bool synced = false;
+    std::uint32_t next_sequence = 0;
+    std::int64_t date = 0;
+    std::int64_t close = 0;
+    std::int64_t volume = 0;
+  };
+
+  std::unordered_map<std::uint32_t, SymbolState> symbols_;
+  std::uint64_t dropped_batches_;
+};
+
+}  // namespace message
+}  // namespace backtestx
+
+#endif /* MESSAGE_BAR_BATCH_HPP */
@@ -0,0 +1,91 @@
+#ifndef MESSAGE_BOOK_MESSAGE_HPP
+#define MESSAGE_BOOK_MESSAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace backtestx {
+namespace message {
+
+// First byte of every binary message. Bar messages are comma separated text
+// starting with a digit, so binary types are kept below '0' to stay distinct.
+enum class MessageType : std::uint8_t {
+  kBookUpdate = 0x01,
+  kBookSnapshot = 0x02,
+  kBarBatch = 0x03,
+};
+
+enum class BookAction : std::uint8_t { kAdd = 0, kModify = 1, kDelete = 2 };
+
+enum class Side : std::uint8_t { kBid = 0, kAsk = 1 };
+
+// Change of a single aggregated price level (market by price). Updates of a
+// symbol are numbered consecutively, so a subscriber can tell when it missed
+// one.
+struct BookUpdateMessage {
+  std::uint8_t type;
+  std::uint8_t action;
+  std::uint8_t side;
+  std::uint8_t reserved;
+  std::uint32_t symbol_id;
+  std::int64_t timestamp_ns;
+  std::int64_t price_ticks;
+  std::int64_t quantity;
+  std::uint32_t sequence;
+  std::uint32_t reserved2;
+};
+
+// State of a book, sent periodically so that a late joiner, or a subscriber
+// that missed an update, can get back in sync. The header is followed by
+// bid_count bid levels and then ask_count ask levels, best first; deep levels
+// that do not fit in a message are left out. sequence is the sequence of the
+// next update of the symbol.
+struct BookSnapshotHeader {
+  std::uint8_t type;
+  std::uint8_t reserved[3];
+  std::uint32_t symbol_id;
+  std::int64_t timestamp_ns;
+  std::uint32_t bid_count;
+  std::uint32_t ask_count;
+  std::uint32_t sequence;
+  std::uint32_t reserved2;
+};
+
+struct BookLevel {
+  std::int64_t price_ticks;
+  std::int64_t quantity;
+};
+
+static_assert(sizeof(BookUpdateMessage) == 40, "Unexpected padding");
+static_assert(sizeof(BookSnapshotHeader) == 32, "Unexpected padding");
+static_assert(sizeof(BookLevel) == 16, "Unexpected padding");
+
+inline bool IsBinaryMessage(const std::uint8_t* data, std::size_t length) {
+  return length > 0 && data[0] < '0';
+}
+
+inline std::size_t SnapshotLength(std::uint32_t bid_count,
+                                  std::uint32_t ask_count) {
+  return sizeof(BookSnapshotHeader) +
+         (static_cast<std::size_t>(bid_count) + ask_count) * sizeof(BookLevel);
+}
+
+// Messages are copied in and out of the transport buffers, which are not
+// guaranteed to be aligned for the structs
+template <typename T>
+inline T ReadMessage(const std::uint8_t* data) {
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+template <typename T>
+inline void WriteMessage(std::uint8_t* data, const T& value) {
+  std::memcpy(data, &value, sizeof(T));
+}
+
+}  // namespace message
+}  // namespace backtestx
+
+#endif /* MESSAGE_BOOK_MESSAGE_HPP */
@@ -6,7 +6,13 @@
 #include <mutex>
 #include <deque>
 #include <atomic>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+
+#include "BackTestX/bar_columns.hpp"
+#include "BackTestX/message/bar_batch.hpp"
+#include "BackTestX/strategy/bar_listener.hpp"
 
 namespace backtestx {
 namespace plot {
@@ -25,23 +31,49 @@ class DataHandler {
   DataHandler();
   ~DataHandler();
 
+  // Parse a bar message. Messages may end with the bar's row index in the
+  // source file; without it rows are assumed to be consecutive.
   void ProcessData(const std::string& data);
 
+  // Decode a compressed batch of bars. Only the symbol of the first batch
+  // decoded is stored; batches of other symbols are dropped.
+  void ProcessBatch(const std::uint8_t* data, std::size_t length);
+
   bool GetDataReadyFlag() const;
   void ResetDataReadyFlag();
   std::vector<StockData> GetStockData();
 
+  // Append bars [from, end) to out and return the new bar count, together
+  // with the source row index following the last bar
+  std::size_t CopyBarsSince(std::size_t from, BarColumns& out,
+                            std::uint64_t& next_row);
+
+  // Replace the stored bars with restored state. Bars that are not newer
+  // than the last restored bar are dropped afterwards, so a replay from the
+  // start of the stream does not duplicate them.
+  void RestoreBars(BarColumns&& bars, std::uint64_t next_row);
+
+  // Notify a strategy of every new bar, on the thread calling ProcessData.
+  // The bars already stored, such as those restored from a checkpoint, are
+  // replayed to the new listener first, so its state is the same as if it
+  // had seen the whole stream.
+  void SetBarListener(std::shared_ptr<strategy::BarListener> listener);
+
  private:
   std::mutex data_mutex_;
   std::atomic<bool> data_ready_;
 
   // Storage for financial data
-  std::vector<double> dates_;
-  std::vector<double> closes_;
-  std::vector<int> volumes_;
-  std::vector<double> opens_;
-  std::vector<double> highs_;
-  std::vector<double> lows_;
+  BarColumns bars_;
+  std::uint64_t next_row_;
+  double resume_after_date_;
+  bool resuming_;
+
+  message::BarBatchDecoder batch_decoder_;
+  bool has_symbol_;
+  std::uint32_t symbol_id_;
+
+  std::shared_ptr<strategy::BarListener> bar_listener_;
 };
 }  // namespace plot
 }  // namespace backtestx
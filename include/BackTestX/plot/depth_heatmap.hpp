@@ -0,0 +1,42 @@
+#ifndef PLOT_DEPTH_HEATMAP_HPP
+#define PLOT_DEPTH_HEATMAP_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "imgui.h"
+#include "implot/implot.h"
+
+#include "BackTestX/book/book_store.hpp"
+
+namespace backtestx {
+namespace plot {
+
+// Heatmap of order book depth over time. Rows are price levels counted from
+// the touch (asks above, bids below) and columns are periodic samples.
+class DepthHeatmap {
+ public:
+  DepthHeatmap();
+
+  void RenderDepthHeatmap(std::shared_ptr<book::BookStore>& book_store_);
+
+ private:
+  static const int LEVELS = 20;
+  static const int HISTORY = 300;
+  static constexpr double SAMPLE_INTERVAL_S = 0.1;
+
+  std::vector<double> values_;
+  std::uint32_t symbol_id_;
+  bool has_symbol_;
+  double last_sample_time_;
+
+  std::vector<book::BookLevel> bids_;
+  std::vector<book::BookLevel> asks_;
+
+  void Sample(book::BookStore& book_store);
+};
+}  // namespace plot
+}  // namespace backtestx
+
+#endif /* PLOT_DEPTH_HEATMAP_HPP */
@@ -0,0 +1,114 @@
+#ifndef RESULTS_RECORDS_HPP
+#define RESULTS_RECORDS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace backtestx {
+namespace results {
+
+// Fixed-size records produced by a backtest. A run_id tells apart the
+// strategies or parameter sets sharing a results file.
+enum class RecordType : std::uint32_t {
+  kFill = 0,
+  kOrderEvent = 1,
+  kEquityPoint = 2,
+};
+
+static const std::size_t RECORD_TYPE_COUNT = 3;
+
+enum class OrderEventType : std::uint8_t {
+  kNew = 0,
+  kAcknowledged = 1,
+  kCancelled = 2,
+  kRejected = 3,
+};
+
+// Execution of an order. The quantity is positive for buys and negative for
+// sells.
+struct Fill {
+  std::int64_t timestamp_ns;
+  std::uint64_t order_id;
+  std::uint32_t run_id;
+  std::uint32_t symbol_id;
+  double price;
+  double quantity;
+  double fee;
+};
+
+struct OrderEvent {
+  std::int64_t timestamp_ns;
+  std::uint64_t order_id;
+  std::uint32_t run_id;
+  std::uint32_t symbol_id;
+  double price;
+  double quantity;
+  std::uint8_t event;
+  std::uint8_t reserved[7];
+};
+
+// Equity and position of a run after a bar
+struct EquityPoint {
+  std::int64_t timestamp_ns;
+  std::uint32_t run_id;
+  std::uint32_t symbol_id;
+  double equity;
+  double position;
+  double price;
+};
+
+static_assert(sizeof(Fill) == 48, "Unexpected padding");
+static_assert(sizeof(OrderEvent) == 48, "Unexpected padding");
+static_assert(sizeof(EquityPoint) == 40, "Unexpected padding");
+
+template <typename T>
+struct RecordTraits;
+
+template <>
+struct RecordTraits<Fill> {
+  static const RecordType kType = RecordType::kFill;
+};
+
+template <>
+struct RecordTraits<OrderEvent> {
+  static const RecordType kType = RecordType::kOrderEvent;
+};
+
+template <>
+struct RecordTraits<EquityPoint> {
+  static const RecordType kType = RecordType::kEquityPoint;
+};
+
+enum class ColumnType : std::uint8_t {
+  kInt64,
+  kUInt64,
+  kUInt32,
+  kUInt8,
+  kDouble,
+};
+
+// Field of a record, stored as one column of a results file block
+struct ColumnInfo {
+  const char* name;
+  std::size_t offset;
+  ColumnType type;
+};
+
+std::size_t ColumnWidth(ColumnType type);
+
+// Columns of a record type, in the order they are stored
+const std::vector<ColumnInfo>& ColumnsOf(RecordType type);
+
+std::size_t RecordSize(RecordType type);
+
+// Name used on the command line and in exports, e.g. "fills"
+const char* RecordTypeName(RecordType type);
+
+// Parse a record type name, returning false if it is unknown
+bool ParseRecordType(const char* name, RecordType& type);
+
+}  // namespace results
+}  // namespace backtestx
+
+#endif /* RESULTS_RECORDS_HPP */
@@ -0,0 +1,54 @@
+#ifndef RESULTS_RESULTS_READER_HPP
+#define RESULTS_RESULTS_READER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "BackTestX/results/records.hpp"
+#include "BackTestX/results/results_writer.hpp"
+
+namespace backtestx {
+namespace results {
+
+// Block of a results file with its columns loaded
+struct ResultsBlock {
+  BlockHeader header;
+  std::vector<std::uint8_t> data;
+  std::vector<const std::uint8_t*> columns;  // start of each column in data
+
+  RecordType Type() const {
+    return static_cast<RecordType>(header.record_type);
+  }
+};
+
+// Sequential reader of the files written by ResultsWriter
+class ResultsReader {
+ public:
+  ResultsReader();
+
+  bool Open(const std::string& path);
+
+  // Read the next block, returning false at the end of the file or if the
+  // file is truncated
+  bool Next(ResultsBlock& block);
+
+  const ResultsFileHeader& Header() const { return header_; }
+
+ private:
+  std::ifstream file_;
+  ResultsFileHeader header_;
+};
+
+// Write the records of one type as CSV, with a header row of column names.
+// Returns the number of records written.
+std::uint64_t ExportCsv(ResultsReader& reader, RecordType type,
+                        std::ostream& out);
+
+}  // namespace results
+}  // namespace backtestx
+
+#endif /* RESULTS_RESULTS_READER_HPP */
@@ -0,0 +1,149 @@
+#ifndef RESULTS_RESULTS_WRITER_HPP
+#define RESULTS_RESULTS_WRITER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BackTestX/results/records.hpp"
+
+namespace backtestx {
+namespace results {
+
+static const std::uint32_t RESULTS_MAGIC = 0x52585442;  // "BTXR"
+static const std::uint32_t RESULTS_VERSION = 1;
+
+// A results file is a ResultsFileHeader followed by blocks. Each block is a
+// BlockHeader followed by the columns of record_count records of one type,
+// one contiguous array per column in ColumnsOf order.
+struct ResultsFileHeader {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::int64_t created_ms;
+};
+
+struct BlockHeader {
+  std::uint32_t record_type;
+  std::uint32_t record_count;
+  std::uint32_t sink_id;
+  std::uint32_t sequence;  // per sink and record type
+};
+
+static_assert(sizeof(ResultsFileHeader) == 16, "Unexpected padding");
+static_assert(sizeof(BlockHeader) == 16, "Unexpected padding");
+
+class ResultsSink;
+
+// Writes results to a columnar binary file on a background thread. Producers
+// append records to a ResultsSink each; full buffers are queued to the writer
+// thread, which transposes them into columns and writes them out, then hands
+// the buffers back for reuse.
+class ResultsWriter {
+ public:
+  static const std::size_t DEFAULT_RECORDS_PER_BUFFER = 4096;
+
+  explicit ResultsWriter(
+      std::size_t records_per_buffer = DEFAULT_RECORDS_PER_BUFFER);
+  ~ResultsWriter();
+
+  // Do not allow copy
+  ResultsWriter(const ResultsWriter&) = delete;
+  ResultsWriter& operator=(const ResultsWriter&) = delete;
+
+  // Create or truncate the file and start the writer thread
+  bool Open(const std::string& path);
+
+  // Create a sink for the calling thread. Sinks must be destroyed, which
+  // flushes them, before the writer is closed.
+  std::unique_ptr<ResultsSink> CreateSink();
+
+  // Write out every queued buffer and stop the writer thread
+  void Close();
+
+ private:
+  friend class ResultsSink;
+
+  struct Buffer {
+    RecordType type;
+    std::uint32_t sink_id;
+    std::uint32_t sequence;
+    std::size_t count;
+    std::vector<std::uint8_t> bytes;
+  };
+
+  std::size_t records_per_buffer_;
+  std::ofstream file_;
+  std::thread thread_;
+  std::uint32_t next_sink_id_;
+  bool stop_requested_;
+  bool failed_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::unique_ptr<Buffer>> queue_;
+  std::vector<std::unique_ptr<Buffer>> free_[RECORD_TYPE_COUNT];
+
+  std::vector<std::uint8_t> columns_;  // scratch of the writer thread
+
+  std::unique_ptr<Buffer> NewBuffer(RecordType type);
+
+  // Queue a buffer for writing and return an empty one in exchange, taken
+  // from the buffers already written or newly allocated if there are none.
+  // This only holds the lock for the queue operations, never for I/O.
+  std::unique_ptr<Buffer> Exchange(std::unique_ptr<Buffer> full);
+
+  void WriteBlock(const Buffer& buffer);
+  void WriterThread();
+};
+
+// Per-thread front end of a ResultsWriter. Records are copied into the
+// current buffer of their type; when it is full it is swapped with an empty
+// one while the writer thread writes it out, so appending never waits for
+// the disk.
+class ResultsSink {
+ public:
+  ~ResultsSink();
+
+  // Do not allow copy
+  ResultsSink(const ResultsSink&) = delete;
+  ResultsSink& operator=(const ResultsSink&) = delete;
+
+  template <typename T>
+  void Append(const T& record) {
+    ResultsWriter::Buffer& buffer =
+        *current_[static_cast<std::size_t>(RecordTraits<T>::kType)];
+    std::memcpy(buffer.bytes.data() + buffer.count * sizeof(T), &record,
+                sizeof(T));
+    if (++buffer.count == writer_.records_per_buffer_) {
+      Submit(RecordTraits<T>::kType);
+    }
+  }
+
+  // Queue the records appended so far
+  void Flush();
+
+ private:
+  friend class ResultsWriter;
+
+  ResultsSink(ResultsWriter& writer, std::uint32_t id);
+
+  ResultsWriter& writer_;
+  std::uint32_t id_;
+  std::uint32_t sequence_[RECORD_TYPE_COUNT];
+  std::unique_ptr<ResultsWriter::Buffer> current_[RECORD_TYPE_COUNT];
+
+  void Submit(RecordType type);
+};
+
+}  // namespace results
+}  // namespace backtestx
+
+#endif /* RESULTS_RESULTS_WRITER_HPP */
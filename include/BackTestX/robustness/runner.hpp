@@ -0,0 +1,238 @@
+#ifndef ROBUSTNESS_RUNNER_HPP
+#define ROBUSTNESS_RUNNER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "BackTestX/bar_columns.hpp"
+#include "BackTestX/csv_reader.hpp"
+
+namespace backtestx {
+namespace robustness {
+
+// xoshiro256** generator. Every task gets its own stream derived from the run
+// seed and the task index, so results do not depend on which thread runs it.
+class Rng {
+ public:
+  explicit Rng(std::uint64_t seed);
+
+  static Rng ForTask(std::uint64_t seed, std::uint64_t task);
+
+  std::uint64_t Next();
+
+  // Uniform in [0, 1)
+  double NextDouble();
+
+  // Uniform in [0, bound)
+  std::uint64_t NextBelow(std::uint64_t bound);
+
+ private:
+  std::uint64_t state_[4];
+};
+
+// Mean, variance and range in a single pass (Welford), mergeable across
+// partial results
+class RunningStats {
+ public:
+  RunningStats();
+
+  void Add(double x);
+  void Merge(const RunningStats& other);
+
+  std::uint64_t Count() const { return count_; }
+  double Mean() const { return mean_; }
+  double Variance() const;
+  double StdDev() const;
+  double Min() const { return min_; }
+  double Max() const { return max_; }
+
+ private:
+  std::uint64_t count_;
+  double mean_;
+  double m2_;
+  double min_;
+  double max_;
+};
+
+// Fixed-bin histogram for approximate quantiles. Values outside [low, high)
+// are clamped into the first or last bin.
+class Histogram {
+ public:
+  Histogram(double low = -1.0, double high = 1.0, std::size_t bins = 200);
+
+  void Add(double x);
+  void Merge(const Histogram& other);
+
+  // Value below which a fraction q of the samples lie, at bin resolution
+  double Quantile(double q) const;
+
+  // Empty histogram with the same binning
+  Histogram EmptyCopy() const { return Histogram(low_, high_, counts_.size()); }
+
+ private:
+  double low_;
+  double high_;
+  double scale_;
+  std::uint64_t total_;
+  std::vector<std::uint64_t> counts_;
+};
+
+// Distribution of a per-task statistic
+struct Distribution {
+  RunningStats stats;
+  Histogram histogram;
+
+  explicit Distribution(const Histogram& prototype = Histogram())
+      : histogram(prototype.EmptyCopy()) {}
+
+  void Add(double x) {
+    stats.Add(x);
+    histogram.Add(x);
+  }
+
+  void Merge(const Distribution& other) {
+    stats.Merge(other.stats);
+    histogram.Merge(other.histogram);
+  }
+};
+
+struct RunnerOptions {
+  std::uint64_t seed = 1;
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  // Tasks aggregated together before merging. The merge order only depends
+  // on this, never on the thread count.
+  std::size_t tasks_per_block = 64;
+};
+
+// Rolling in-sample / out-of-sample window over bar indices
+struct Window {
+  std::size_t in_begin;
+  std::size_t in_end;
+  std::size_t out_begin;
+  std::size_t out_end;
+};
+
+std::vector<Window> WalkForwardWindows(std::size_t bar_count,
+                                       std::size_t in_sample,
+                                       std::size_t out_of_sample,
+                                       std::size_t step);
+
+// Convert the output of CsvReader into a bar column store
+BarColumns ToBarColumns(const CsvReader::CsvData& data);
+
+// Log returns of consecutive closes
+std::vector<double> LogReturns(const std::vector<double>& closes);
+
+// Stationary bootstrap (Politis & Romano): blocks start at random positions
+// and have geometric lengths with the given mean. A mean block length of 1
+// gives the plain i.i.d. bootstrap, suitable for resampling trades.
+void StationaryBootstrap(const std::vector<double>& source,
+                         double mean_block_length, Rng& rng,
+                         std::vector<double>& path);
+
+// Run task_count independent tasks in parallel and aggregate the value each
+// returns. fn(task, rng, scratch) is given the task's own random stream and a
+// per-thread scratch buffer. Tasks are aggregated in fixed-size blocks which
+// are merged in block order, so the result is identical for a given seed
+// whatever the thread count.
+template <typename TaskFn>
+Distribution RunTasks(std::size_t task_count, const RunnerOptions& options,
+                      const Histogram& prototype, TaskFn fn) {
+  const std::size_t block_size =
+      std::max<std::size_t>(1, options.tasks_per_block);
+  const std::size_t block_count = (task_count + block_size - 1) / block_size;
+  std::vector<Distribution> blocks(block_count, Distribution(prototype));
+  std::atomic<std::size_t> next_block(0);
+
+  auto worker = [&]() {
+    std::vector<double> scratch;
+    for (std::size_t block = next_block++; block < block_count;
+         block = next_block++) {
+      const std::size_t end = std::min(task_count, (block + 1) * block_size);
+      for (std::size_t task = block * block_size; task < end; ++task) {
+        Rng rng = Rng::ForTask(options.seed, task);
+        blocks[block].Add(fn(task, rng, scratch));
+      }
+    }
+  };
+
+  const unsigned thread_count = static_cast<unsigned>(std::min<std::size_t>(
+      std::max(1u, options.threads), std::max<std::size_t>(1, block_count)));
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < thread_count; ++i) threads.emplace_back(worker);
+  worker();
+  for (auto& thread : threads) thread.join();
+
+  Distribution result(prototype);
+  for (const auto& block : blocks) result.Merge(block);
+  return result;
+}
+
+// Distribution of metric(path, length) over resampled paths of samples
+template <typename Metric>
+Distribution Bootstrap(const std::vector<double>& samples, std::size_t paths,
+                       double mean_block_length, const RunnerOptions& options,
+                       const Histogram& prototype, Metric metric) {
+  return RunTasks(paths, options, prototype,
+                  [&](std::size_t, Rng& rng, std::vector<double>& path) {
+                    StationaryBootstrap(samples, mean_block_length, rng, path);
+                    return metric(path.data(), path.size());
+                  });
+}
+
+struct WalkForwardResult {
+  // Out-of-sample score of the in-sample optimum, over all windows
+  Distribution out_of_sample;
+  // Index into the parameter grid chosen for each window
+  std::vector<std::size_t> chosen;
+};
+
+// For every window, pick the parameters maximising the in-sample objective
+// (ties go to the lowest index) and score them out of sample.
+// objective(bars, warmup_begin, begin, end, params) scores [begin, end) and
+// must be thread safe. Bars from warmup_begin on may be used to warm up
+// indicators: the in-sample score starts cold at in_begin, while the
+// out-of-sample score is warmed up over the in-sample bars, as if the strategy
+// had been running all along.
+template <typename Params, typename Objective>
+WalkForwardResult WalkForward(const BarColumns& bars,
+                              const std::vector<Window>& windows,
+                              const std::vector<Params>& grid,
+                              const RunnerOptions& options,
+                              const Histogram& prototype,
+                              Objective objective) {
+  WalkForwardResult result{Distribution(prototype),
+                           std::vector<std::size_t>(windows.size(), 0)};
+  if (grid.empty()) return result;
+
+  result.out_of_sample = RunTasks(
+      windows.size(), options, prototype,
+      [&](std::size_t task, Rng&, std::vector<double>&) {
+        const Window& window = windows[task];
+        std::size_t best = 0;
+        double best_score = -std::numeric_limits<double>::infinity();
+        for (std::size_t i = 0; i < grid.size(); ++i) {
+          const double score = objective(bars, window.in_begin,
+                                         window.in_begin, window.in_end,
+                                         grid[i]);
+          if (score > best_score) {
+            best_score = score;
+            best = i;
+          }
+        }
+        result.chosen[task] = best;
+        return objective(bars, window.in_begin, window.out_begin,
+                         window.out_end, grid[best]);
+      });
+  return result;
+}
+
+}  // namespace robustness
+}  // namespace backtestx
+
+#endif /* ROBUSTNESS_RUNNER_HPP */
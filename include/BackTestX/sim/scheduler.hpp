@@ -0,0 +1,171 @@
+#ifndef SIM_SCHEDULER_HPP
+#define SIM_SCHEDULER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "BackTestX/bar_columns.hpp"
+#include "BackTestX/strategy/bar_listener.hpp"
+
+namespace backtestx {
+namespace sim {
+
+// Simulated time in nanoseconds
+typedef std::uint64_t SimTime;
+
+static const SimTime NANOS_PER_MILLI = 1000000;
+static const SimTime NANOS_PER_SECOND = 1000000000;
+
+// Bar dates are seconds since the epoch. Dates before the epoch, and dates
+// that are not a number, map to time zero; dates past the range of SimTime
+// saturate.
+inline SimTime FromBarDate(double date) {
+  static const SimTime MAX_SECONDS =
+      std::numeric_limits<SimTime>::max() / NANOS_PER_SECOND;
+  if (!(date > 0)) return 0;
+  if (date >= static_cast<double>(MAX_SECONDS)) {
+    return MAX_SECONDS * NANOS_PER_SECOND;
+  }
+  return static_cast<SimTime>(date) * NANOS_PER_SECOND;
+}
+
+// Events carry a plain function pointer with a context and a data word
+// instead of a std::function, so scheduling never allocates
+typedef void (*EventCallback)(void* context, std::uint64_t data);
+
+// Identifies a scheduled event. The generation guards against cancelling a
+// later event that reuses the same pooled node.
+struct EventHandle {
+  std::uint32_t index = 0;
+  std::uint32_t generation = 0;
+};
+
+// Deterministic discrete-event scheduler. Pending events are kept in a radix
+// heap keyed by time: bucket i holds the events whose time differs from the
+// last extracted time in bit i - 1 at the highest, so insertion is O(1) and
+// each event is moved to a lower bucket at most 64 times. Buckets are arrays
+// of (time, node) pairs that are only ever appended to, which keeps events
+// with equal times in the order they were scheduled and lets a bucket be
+// redistributed without touching the nodes. Event nodes come from a pool and
+// cancellation only marks the node; it is recycled when the heap reaches it.
+//
+// The clock only moves forward. It advances to the time of each event as it
+// runs, and to the target of RunUntil, which lets the scheduler be driven by
+// replayed bar timestamps as well as by a simulated clock.
+class Scheduler {
+ public:
+  explicit Scheduler(std::size_t initial_capacity = 1024);
+
+  // Do not allow copy
+  Scheduler(const Scheduler&) = delete;
+  Scheduler& operator=(const Scheduler&) = delete;
+
+  SimTime Now() const { return now_; }
+
+  // Schedule an event at an absolute time, which must not be in the past
+  EventHandle Schedule(SimTime time, EventCallback callback, void* context,
+                       std::uint64_t data = 0);
+
+  // Schedule an event delay nanoseconds from now
+  EventHandle ScheduleAfter(SimTime delay, EventCallback callback,
+                            void* context, std::uint64_t data = 0);
+
+  // Schedule an event at first and then every period until cancelled. A
+  // period of 0 schedules a single event.
+  EventHandle SchedulePeriodic(SimTime first, SimTime period,
+                               EventCallback callback, void* context,
+                               std::uint64_t data = 0);
+
+  // Cancel a pending event, or stop a periodic one from inside its callback.
+  // Returns false if the event already ran or was cancelled.
+  bool Cancel(EventHandle handle);
+
+  // Run the next pending event, advancing the clock to its time. Returns
+  // false when no event is pending.
+  bool RunNext();
+
+  // Run every event due at or before time, then advance the clock to time.
+  // Returns the number of events run.
+  std::size_t RunUntil(SimTime time);
+
+  // Advance the clock by delta, running the events due meanwhile
+  std::size_t AdvanceBy(SimTime delta) { return RunUntil(now_ + delta); }
+
+  // Number of events that will still run
+  std::size_t Pending() const { return pending_; }
+  bool Empty() const { return pending_ == 0; }
+
+ private:
+  static const std::uint32_t NIL = 0xffffffff;
+  static const int BUCKET_COUNT = 65;
+
+  enum State : std::uint8_t { kFree, kPending, kRunning, kCancelled };
+
+  struct Node {
+    SimTime time;
+    SimTime period;
+    EventCallback callback;
+    void* context;
+    std::uint64_t data;
+    std::uint32_t next;  // free list link
+    std::uint32_t generation;
+    State state;
+  };
+
+  struct Entry {
+    SimTime time;
+    std::uint32_t index;
+  };
+
+  std::vector<Node> nodes_;
+  std::uint32_t free_head_;
+  std::vector<Entry> buckets_[BUCKET_COUNT];
+  std::uint64_t occupied_;  // bit b - 1 is set when bucket b > 0 is not empty
+  std::size_t front_;  // next entry of bucket 0 to run
+  SimTime last_;       // time of the last extracted minimum, the heap's base
+  SimTime now_;
+  std::size_t pending_;
+  std::size_t cancelled_;  // cancelled nodes still in the heap
+
+  std::uint32_t Allocate();
+  void Release(std::uint32_t index);
+
+  void Push(SimTime time, std::uint32_t index) {
+    const int b = BucketOf(time);
+    buckets_[b].push_back(Entry{time, index});
+    if (b > 0) occupied_ |= 1ULL << (b - 1);
+  }
+
+  // Remove the earliest live event from the heap if it is due at or before
+  // limit, returning its node or NIL
+  std::uint32_t PopDue(SimTime limit);
+
+  void Run(std::uint32_t index);
+
+  int BucketOf(SimTime time) const {
+    return time == last_ ? 0 : 64 - __builtin_clzll(time ^ last_);
+  }
+};
+
+// Drives a scheduler from live bars: before each bar is forwarded to the
+// downstream listener, the clock is advanced to the bar's timestamp and the
+// events due by then are run. Install it with DataHandler::SetBarListener.
+class BarClock : public strategy::BarListener {
+ public:
+  BarClock(Scheduler& scheduler,
+           std::shared_ptr<strategy::BarListener> downstream = nullptr);
+
+  void OnBar(const BarColumns& bars, std::size_t index) override;
+
+ private:
+  Scheduler& scheduler_;
+  std::shared_ptr<strategy::BarListener> downstream_;
+};
+
+}  // namespace sim
+}  // namespace backtestx
+
+#endif /* SIM_SCHEDULER_HPP */
@@ -0,0 +1,149 @@
+#ifndef STATS_COUNTERS_HPP
+#define STATS_COUNTERS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace backtestx {
+namespace stats {
+
+// Identifiers of the runtime counters. The order defines the slot index in the
+// counters file, so new counters must be appended before kCounterCount.
+enum CounterId : std::uint32_t {
+  kMessagesSent = 0,
+  kBytesSent,
+  kOfferBackPressured,
+  kOfferNotConnected,
+  kOfferAdminAction,
+  kOfferClosed,
+  kOfferUnknown,
+  kMessagesReceived,
+  kBytesReceived,
+  kParseErrors,
+  kRingOccupancy,
+  kStoreSize,
+  kGuiFrameTimeNs,
+  kReadAheadChunks,
+  kBookUpdates,
+  kResultsBytesWritten,
+  kBarBatchesDropped,
+  kBookUpdatesDropped,
+  kBookSnapshots,
+  kCounterCount
+};
+
+// Totals are monotonic and reported as rates, gauges are reported as is.
+enum CounterKind : std::uint32_t { kTotal = 0, kGauge = 1 };
+
+static const std::uint32_t COUNTERS_MAGIC = 0x58544243;  // "CBTX"
+static const std::uint32_t COUNTERS_VERSION = 1;
+static const std::size_t CACHE_LINE_SIZE = 64;
+
+// Each counter owns a full cache line so that writers on different threads
+// never share a line.
+struct alignas(CACHE_LINE_SIZE) CounterSlot {
+  std::atomic<std::uint64_t> value;
+  std::uint32_t kind;
+  char label[CACHE_LINE_SIZE - sizeof(std::uint64_t) - sizeof(std::uint32_t)];
+};
+
+struct alignas(CACHE_LINE_SIZE) CountersHeader {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t counter_count;
+  std::int32_t pid;
+  std::int64_t start_time_ms;
+};
+
+static_assert(sizeof(CounterSlot) == CACHE_LINE_SIZE,
+              "Counter slot must fill exactly one cache line");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "Counters must be lock free to live in shared memory");
+
+// Memory-mapped file holding the counters of a single process. The owning
+// process creates it, while monitoring tools such as btx-stat attach to it
+// read-only.
+class CountersFile {
+ public:
+  CountersFile();
+  ~CountersFile();
+
+  // Do not allow copy
+  CountersFile(const CountersFile &) = delete;
+  CountersFile &operator=(const CountersFile &) = delete;
+
+  // Create the file and initialise every counter to zero. A file left by a
+  // process that has exited is replaced, while one whose process is still
+  // running is refused. The file is removed again on destruction.
+  void Create(const std::string &path);
+
+  // Map an existing file created by another process
+  void Attach(const std::string &path);
+
+  // Remove the name of the created file, keeping the mapping
+  void Unlink();
+
+  const CountersHeader *Header() const { return header_; }
+  CounterSlot *Slots() const { return slots_; }
+  std::uint32_t CounterCount() const;
+
+  static std::size_t FileSize(std::uint32_t counter_count);
+
+ private:
+  void *address_;
+  std::size_t length_;
+  CountersHeader *header_;
+  CounterSlot *slots_;
+  std::string created_path_;
+
+  void Unmap();
+};
+
+// Default location of the counters file of this process, named after its
+// role, e.g. "publisher", and its pid so that several instances can run on
+// the same host
+std::string DefaultCountersPath(const std::string &name);
+
+// Counters files in the default location, sorted by name
+std::vector<std::string> ListCountersFiles();
+
+bool ProcessAlive(std::int32_t pid);
+
+// Back the process-wide counters with a memory-mapped file. Until this is
+// called, counters are kept in process-local memory. The mapping is kept
+// until the process exits, so threads still running during static
+// destruction can update counters; only the file name is removed at exit.
+void OpenCounters(const std::string &path);
+
+const char *CounterLabel(CounterId id);
+CounterKind CounterKindOf(CounterId id);
+
+namespace detail {
+extern CounterSlot *g_slots;
+}  // namespace detail
+
+// Counters have a single writer, so a relaxed load/store pair is enough and
+// avoids a locked instruction on the hot path.
+inline void Add(CounterId id, std::uint64_t delta) {
+  std::atomic<std::uint64_t> &value = detail::g_slots[id].value;
+  value.store(value.load(std::memory_order_relaxed) + delta,
+              std::memory_order_relaxed);
+}
+
+inline void Increment(CounterId id) { Add(id, 1); }
+
+inline void Set(CounterId id, std::uint64_t value) {
+  detail::g_slots[id].value.store(value, std::memory_order_relaxed);
+}
+
+inline std::uint64_t Get(CounterId id) {
+  return detail::g_slots[id].value.load(std::memory_order_relaxed);
+}
+
+}  // namespace stats
+}  // namespace backtestx
+
+#endif /* STATS_COUNTERS_HPP */
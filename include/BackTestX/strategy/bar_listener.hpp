@@ -0,0 +1,24 @@
+#ifndef STRATEGY_BAR_LISTENER_HPP
+#define STRATEGY_BAR_LISTENER_HPP
+
+#include <cstddef>
+
+#include "BackTestX/bar_columns.hpp"
+
+namespace backtestx {
+namespace strategy {
+
+// Runtime-polymorphic entry point for consumers of live bars, such as a
+// compiled pipeline wrapped in a PipelineAdapter
+class BarListener {
+ public:
+  virtual ~BarListener() = default;
+
+  // Called once for every new bar, which is bars[index]
+  virtual void OnBar(const BarColumns& bars, std::size_t index) = 0;
+};
+
+}  // namespace strategy
+}  // namespace backtestx
+
+#endif /* STRATEGY_BAR_LISTENER_HPP */
@@ -0,0 +1,208 @@
+#ifndef STRATEGY_PIPELINE_HPP
+#define STRATEGY_PIPELINE_HPP
+
+// Strategies composed at compile time from indicator, signal, sizing and
+// execution stages. Every stage is a concrete type, so the compiler inlines
+// the whole chain into a single loop over the bar columns instead of paying
+// for an indirect call per stage and bar.
+//
+// A pipeline runs several parameter sets ("lanes") side by side. Stages work
+// on arrays of lanes with no dependency between them, which lets the lane
+// loops vectorise for parameter sweeps:
+//
+//   using State = strategy::LaneState<8>;
+//   strategy::Pipeline<State, strategy::EmaIndicator<8>,
+//                      strategy::CrossoverSignal, strategy::FixedSizing,
+//                      strategy::MarkToMarket>
+//       sweep(strategy::EmaIndicator<8>(alphas), strategy::CrossoverSignal(),
+//             strategy::FixedSizing(1.0), strategy::MarkToMarket(0.0));
+//   State state;
+//   sweep.Run(bars, state);
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+#include "BackTestX/bar_columns.hpp"
+#include "BackTestX/strategy/bar_listener.hpp"
+
+namespace backtestx {
+namespace strategy {
+
+// State handed from stage to stage, one entry per lane
+template <std::size_t Lanes>
+struct LaneState {
+  static constexpr std::size_t kLanes = Lanes;
+
+  alignas(64) double indicator[Lanes] = {};
+  alignas(64) double signal[Lanes] = {};
+  alignas(64) double target[Lanes] = {};
+  alignas(64) double position[Lanes] = {};
+  alignas(64) double equity[Lanes] = {};
+
+  double price = 0;
+  double previous_price = 0;
+  std::size_t bars_seen = 0;
+};
+
+// CRTP base of all stages. Derived classes implement
+//   template <typename State>
+//   void Process(const BarColumns& bars, std::size_t index, State& state);
+template <typename Derived>
+class Stage {
+ public:
+  template <typename State>
+  void OnBar(const BarColumns& bars, std::size_t index, State& state) {
+    static_cast<Derived*>(this)->Process(bars, index, state);
+  }
+};
+
+// Exponential moving average of the close, with its own smoothing factor per
+// lane. The first bar seeds the average.
+template <std::size_t Lanes>
+class EmaIndicator : public Stage<EmaIndicator<Lanes>> {
+ public:
+  explicit EmaIndicator(const std::array<double, Lanes>& alphas)
+      : alphas_(alphas) {}
+
+  template <typename State>
+  void Process(const BarColumns&, std::size_t, State& state) {
+    static_assert(State::kLanes == Lanes, "Lane count mismatch");
+    const double price = state.price;
+    if (state.bars_seen == 0) {
+      for (std::size_t l = 0; l < Lanes; ++l) state.indicator[l] = price;
+      return;
+    }
+    // Computing into a local array first rules out aliasing between the
+    // smoothing factors and the state, so the loop vectorises at -O2
+    double next[Lanes];
+    for (std::size_t l = 0; l < Lanes; ++l) {
+      next[l] = state.indicator[l] + alphas_[l] * (price - state.indicator[l]);
+    }
+    for (std::size_t l = 0; l < Lanes; ++l) state.indicator[l] = next[l];
+  }
+
+ private:
+  std::array<double, Lanes> alphas_;
+};
+
+// +1 when the price is above the indicator, -1 below and 0 when equal
+class CrossoverSignal : public Stage<CrossoverSignal> {
+ public:
+  template <typename State>
+  void Process(const BarColumns&, std::size_t, State& state) {
+    const double price = state.price;
+    // Selects rather than bool conversions keep the loop free of branches
+    for (std::size_t l = 0; l < State::kLanes; ++l) {
+      const double distance = price - state.indicator[l];
+      state.signal[l] = distance > 0 ? 1.0 : (distance < 0 ? -1.0 : 0.0);
+    }
+  }
+};
+
+// Target position of a fixed size in the direction of the signal. Long-only
+// sizing turns short signals into a flat position.
+class FixedSizing : public Stage<FixedSizing> {
+ public:
+  explicit FixedSizing(double size, bool long_only = false)
+      : size_(size), floor_(long_only ? 0.0 : -size) {}
+
+  template <typename State>
+  void Process(const BarColumns&, std::size_t, State& state) {
+    for (std::size_t l = 0; l < State::kLanes; ++l) {
+      const double target = state.signal[l] * size_;
+      state.target[l] = target < floor_ ? floor_ : target;
+    }
+  }
+
+ private:
+  double size_;
+  double floor_;
+};
+
+// Fills at the close: marks the held position to market, then trades to the
+// target paying a cost per unit traded
+class MarkToMarket : public Stage<MarkToMarket> {
+ public:
+  explicit MarkToMarket(double cost_per_unit) : cost_(cost_per_unit) {}
+
+  template <typename State>
+  void Process(const BarColumns&, std::size_t, State& state) {
+    const double move =
+        state.bars_seen == 0 ? 0.0 : state.price - state.previous_price;
+    for (std::size_t l = 0; l < State::kLanes; ++l) {
+      const double traded = state.target[l] - state.position[l];
+      const double abs_traded = traded < 0 ? -traded : traded;
+      state.equity[l] += state.position[l] * move - cost_ * abs_traded;
+      state.position[l] = state.target[l];
+    }
+  }
+
+ private:
+  double cost_;
+};
+
+// Static chain of stages run in order on every bar
+template <typename State, typename... Stages>
+class Pipeline {
+ public:
+  using StateType = State;
+
+  explicit Pipeline(Stages... stages) : stages_(std::move(stages)...) {}
+
+  // Process a single bar
+  void Step(const BarColumns& bars, std::size_t index, State& state) {
+    state.price = bars.closes[index];
+    StepStages(bars, index, state, std::index_sequence_for<Stages...>());
+    state.previous_price = state.price;
+    ++state.bars_seen;
+  }
+
+  // Process bars [begin, end)
+  void Run(const BarColumns& bars, std::size_t begin, std::size_t end,
+           State& state) {
+    for (std::size_t i = begin; i < end; ++i) Step(bars, i, state);
+  }
+
+  void Run(const BarColumns& bars, State& state) {
+    Run(bars, 0, bars.size(), state);
+  }
+
+ private:
+  std::tuple<Stages...> stages_;
+
+  template <std::size_t... Is>
+  void StepStages(const BarColumns& bars, std::size_t index, State& state,
+                  std::index_sequence<Is...>) {
+    (std::get<Is>(stages_).OnBar(bars, index, state), ...);
+  }
+};
+
+// Wraps a compiled pipeline behind the BarListener interface so it can be
+// attached to a DataHandler. This costs one virtual call per bar, the stages
+// themselves stay inlined.
+template <typename PipelineType>
+class PipelineAdapter : public BarListener {
+ public:
+  using State = typename PipelineType::StateType;
+
+  explicit PipelineAdapter(PipelineType pipeline)
+      : pipeline_(std::move(pipeline)) {}
+
+  void OnBar(const BarColumns& bars, std::size_t index) override {
+    pipeline_.Step(bars, index, state_);
+  }
+
+  const State& GetState() const { return state_; }
+
+ private:
+  PipelineType pipeline_;
+  State state_;
+};
+
+}  // namespace strategy
+}  // namespace backtestx
+
+#endif /* STRATEGY_PIPELINE_HPP */
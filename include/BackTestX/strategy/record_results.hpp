@@ -0,0 +1,77 @@
+#ifndef STRATEGY_RECORD_RESULTS_HPP
+#define STRATEGY_RECORD_RESULTS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "BackTestX/bar_columns.hpp"
+#include "BackTestX/results/results_writer.hpp"
+#include "BackTestX/strategy/pipeline.hpp"
+
+namespace backtestx {
+namespace strategy {
+
+// Records the equity and position of every lane after each bar, and a fill at
+// the close whenever the position of a lane changed. Lane l is recorded as run
+// first_run_id + l. Place it after MarkToMarket.
+template <std::size_t Lanes>
+class RecordResults : public Stage<RecordResults<Lanes>> {
+ public:
+  explicit RecordResults(results::ResultsSink* sink, double cost_per_unit = 0,
+                         std::uint32_t symbol_id = 0,
+                         std::uint32_t first_run_id = 0)
+      : sink_(sink),
+        cost_(cost_per_unit),
+        symbol_id_(symbol_id),
+        first_run_id_(first_run_id),
+        next_order_id_(0),
+        previous_position_() {}
+
+  template <typename State>
+  void Process(const BarColumns& bars, std::size_t index, State& state) {
+    static_assert(State::kLanes == Lanes, "Lane count mismatch");
+    const std::int64_t timestamp_ns =
+        static_cast<std::int64_t>(bars.dates[index]) * 1000000000;
+
+    for (std::size_t l = 0; l < Lanes; ++l) {
+      const std::uint32_t run_id =
+          first_run_id_ + static_cast<std::uint32_t>(l);
+      const double traded = state.position[l] - previous_position_[l];
+      if (traded != 0) {
+        results::Fill fill;
+        fill.timestamp_ns = timestamp_ns;
+        fill.order_id = ++next_order_id_;
+        fill.run_id = run_id;
+        fill.symbol_id = symbol_id_;
+        fill.price = state.price;
+        fill.quantity = traded;
+        fill.fee = cost_ * (traded < 0 ? -traded : traded);
+        sink_->Append(fill);
+        previous_position_[l] = state.position[l];
+      }
+
+      results::EquityPoint point;
+      point.timestamp_ns = timestamp_ns;
+      point.run_id = run_id;
+      point.symbol_id = symbol_id_;
+      point.equity = state.equity[l];
+      point.position = state.position[l];
+      point.price = state.price;
+      sink_->Append(point);
+    }
+  }
+
+ private:
+  results::ResultsSink* sink_;
+  double cost_;
+  std::uint32_t symbol_id_;
+  std::uint32_t first_run_id_;
+  std::uint64_t next_order_id_;
+  std::array<double, Lanes> previous_position_;
+};
+
+}  // namespace strategy
+}  // namespace backtestx
+
+#endif /* STRATEGY_RECORD_RESULTS_HPP */
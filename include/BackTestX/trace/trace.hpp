@@ -0,0 +1,131 @@
+#ifndef TRACE_TRACE_HPP
+#define TRACE_TRACE_HPP
+
+// Scoped tracing zones exported in the Chrome trace-event format, which can be
+// opened in chrome://tracing or https://ui.perfetto.dev. Tracing is only
+// compiled in when BACKTESTX_ENABLE_TRACING is defined (CMake option
+// ENABLE_TRACING); otherwise every macro below expands to nothing.
+//
+//   BTX_TRACE_START("subscriber.trace.json");
+//   {
+//     BTX_TRACE_SCOPE("ProcessData");
+//     ...
+//   }
+//   BTX_TRACE_STOP();
+//
+// While tracing is running, SIGUSR1 writes the events recorded so far.
+
+#ifdef BACKTESTX_ENABLE_TRACING
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace backtestx {
+namespace trace {
+
+struct Event {
+  const char *name;
+  std::int64_t start_ns;
+  std::int64_t duration_ns;
+};
+
+// Slot of a thread buffer, guarded by a sequence lock so the flusher can copy
+// it while the owner overwrites it. The sequence is the index of the event
+// plus one, or 0 while the slot is being written; a copy is only kept if the
+// sequence is the expected one both before and after reading the fields.
+struct EventSlot {
+  std::atomic<std::uint64_t> sequence{0};
+  std::atomic<const char *> name{nullptr};
+  std::atomic<std::int64_t> start_ns{0};
+  std::atomic<std::int64_t> duration_ns{0};
+};
+
+// Events recorded by a single thread. The owning thread is the only writer;
+// once full, the oldest events are overwritten.
+struct ThreadBuffer {
+  static const std::size_t CAPACITY = 1 << 16;
+
+  EventSlot slots[CAPACITY];
+  std::atomic<std::uint64_t> head{0};
+  std::uint32_t thread_id = 0;
+  std::string thread_name;
+};
+
+// Allocate and register the buffer of the calling thread
+ThreadBuffer *RegisterThread();
+
+extern thread_local ThreadBuffer *t_buffer;
+
+inline ThreadBuffer &LocalBuffer() {
+  if (!t_buffer) t_buffer = RegisterThread();
+  return *t_buffer;
+}
+
+inline std::int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+inline void Record(const char *name, std::int64_t start_ns,
+                   std::int64_t duration_ns) {
+  ThreadBuffer &buffer = LocalBuffer();
+  const std::uint64_t head = buffer.head.load(std::memory_order_relaxed);
+  EventSlot &slot = buffer.slots[head & (ThreadBuffer::CAPACITY - 1)];
+  slot.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.start_ns.store(start_ns, std::memory_order_relaxed);
+  slot.duration_ns.store(duration_ns, std::memory_order_relaxed);
+  slot.sequence.store(head + 1, std::memory_order_release);
+  buffer.head.store(head + 1, std::memory_order_release);
+}
+
+class Zone {
+ public:
+  explicit Zone(const char *name) : name_(name), start_ns_(NowNs()) {}
+  ~Zone() { Record(name_, start_ns_, NowNs() - start_ns_); }
+
+  // Do not allow copy
+  Zone(const Zone &) = delete;
+  Zone &operator=(const Zone &) = delete;
+
+ private:
+  const char *name_;
+  std::int64_t start_ns_;
+};
+
+// Name shown for the calling thread in the trace viewer
+void SetThreadName(const char *name);
+
+// Start writing traces to the given file on Stop(), exit or SIGUSR1
+void Start(const std::string &path);
+
+// Write all recorded events and stop the background flusher. Does nothing
+// if tracing is not running, so it is safe to call again at exit.
+void Stop();
+
+}  // namespace trace
+}  // namespace backtestx
+
+#define BTX_TRACE_CONCAT_IMPL(a, b) a##b
+#define BTX_TRACE_CONCAT(a, b) BTX_TRACE_CONCAT_IMPL(a, b)
+#define BTX_TRACE_SCOPE(name) \
+  ::backtestx::trace::Zone BTX_TRACE_CONCAT(btx_trace_zone_, __LINE__)(name)
+#define BTX_TRACE_THREAD_NAME(name) ::backtestx::trace::SetThreadName(name)
+#define BTX_TRACE_START(path) ::backtestx::trace::Start(path)
+#define BTX_TRACE_STOP() ::backtestx::trace::Stop()
+
+#else
+
+#define BTX_TRACE_SCOPE(name)
+#define BTX_TRACE_THREAD_NAME(name)
+#define BTX_TRACE_START(path)
+#define BTX_TRACE_STOP()
+
+#endif /* BACKTESTX_ENABLE_TRACING */
+
+#endif /* TRACE_TRACE_HPP */
@@ -0,0 +1,113 @@
+#include "BackTestX/book/book_store.hpp"
+
+#include <algorithm>
+
+#include "BackTestX/stats/counters.hpp"
+#include "BackTestX/trace/trace.hpp"
+
+namespace backtestx {
+namespace book {
+
+BookStore::BookStore() : last_symbol_id_(0), last_book_(nullptr) {}
+
+bool BookStore::ProcessMessage(const std::uint8_t* data, std::size_t length) {
+  using message::MessageType;
+
+  if (length == 0) return false;
+
+  if (data[0] == static_cast<std::uint8_t>(MessageType::kBookUpdate)) {
+    if (length < sizeof(message::BookUpdateMessage)) return false;
+
+    const auto update = message::ReadMessage<message::BookUpdateMessage>(data);
+    const auto last_action =
+        static_cast<std::uint8_t>(message::BookAction::kDelete);
+    if (update.action > last_action ||
+        update.side > static_cast<std::uint8_t>(Side::kAsk)) {
+      return false;
+    }
+
+    std::lock_guard<std::mutex> lock(data_mutex_);
+    SymbolBook& symbol = BookFor(update.symbol_id);
+    if (!symbol.synced || update.sequence != symbol.next_sequence) {
+      // Without the missing update the book would be wrong until the next
+      // snapshot, so show nothing instead
+      if (symbol.synced) symbol.book.Clear();
+      symbol.synced = false;
+      stats::Increment(stats::kBookUpdatesDropped);
+      return true;
+    }
+
+    symbol.book.Apply(static_cast<message::BookAction>(update.action),
+                      static_cast<Side>(update.side), update.price_ticks,
+                      update.quantity);
+    ++symbol.next_sequence;
+    stats::Increment(stats::kBookUpdates);
+    return true;
+  }
+
+  if (data[0] == static_cast<std::uint8_t>(MessageType::kBookSnapshot)) {
+    BTX_TRACE_SCOPE("BookSnapshot");
+    if (length < sizeof(message::BookSnapshotHeader)) return false;
+
+    const auto header = message::ReadMessage<message::BookSnapshotHeader>(data);
+    if (length < message::SnapshotLength(header.bid_count, header.ask_count)) {
+      return false;
+    }
+
+    std::lock_guard<std::mutex> lock(data_mutex_);
+    SymbolBook& symbol = BookFor(header.symbol_id);
+    OrderBook& book = symbol.book;
+    book.Clear();
+    symbol.synced = true;
+    symbol.next_sequence = header.sequence;
+
+    const std::uint8_t* src = data + sizeof(message::BookSnapshotHeader);
+    const std::uint32_t level_count = header.bid_count + header.ask_count;
+    for (std::uint32_t i = 0; i < level_count; ++i) {
+      const auto level = message::ReadMessage<BookLevel>(src);
+      book.SetLevel(i < header.bid_count ? Side::kBid : Side::kAsk,
+                    level.price_ticks, level.quantity);
+      src += sizeof(BookLevel);
+    }
+    stats::Increment(stats::kBookSnapshots);
+    return true;
+  }
+
+  return false;
+}
+
+std::vector<std::uint32_t> BookStore::GetSymbols() {
+  std::lock_guard<std::mutex> lock(data_mutex_);
+
+  std::vector<std::uint32_t> symbols;
+  for (const auto& entry : books_) symbols.push_back(entry.first);
+  std::sort(symbols.begin(), symbols.end());
+  return symbols;
+}
+
+bool BookStore::GetDepth(std::uint32_t symbol_id, std::size_t levels,
+                         std::vector<BookLevel>& bids,
+                         std::vector<BookLevel>& asks) {
+  std::lock_guard<std::mutex> lock(data_mutex_);
+
+  auto it = books_.find(symbol_id);
+  if (it == books_.end()) return false;
+
+  it->second->book.Depth(Side::kBid, levels, bids);
+  it->second->book.Depth(Side::kAsk, levels, asks);
+  return true;
+}
+
+BookStore::SymbolBook& BookStore::BookFor(std::uint32_t symbol_id) {
+  if (last_book_ && last_symbol_id_ == symbol_id) return *last_book_;
+
+  std::unique_ptr<SymbolBook>& book = books_[symbol_id];
+  if (!book) book = std::make_unique<SymbolBook>();
+
+  last_symbol_id_ = symbol_id;
+  last_book_ = book.get();
+  return *book;
+}
+
+}  // namespace book
+}  // namespace backtestx
@@ -0,0 +1,266 @@
+#include "BackTestX/book/order_book.hpp"
+
+#include <algorithm>
+
+namespace backtestx {
+namespace book {
+
+namespace {
+
+std::size_t RoundUpPowerOfTwo(std::size_t n) {
+  std::size_t result = 64;
+  while (result < n) result <<= 1;
+  return result;
+}
+
+}  // namespace
+
+OrderBook::OrderBook(std::size_t window_ticks)
+    : window_(RoundUpPowerOfTwo(window_ticks)), base_(0) {
+  for (SideBook* book : {&bids_, &asks_}) {
+    book->quantity.assign(window_, 0);
+    book->occupied.assign(window_ / 64, 0);
+  }
+}
+
+void OrderBook::Apply(message::BookAction action, Side side,
+                      std::int64_t price_ticks, std::int64_t quantity) {
+  switch (action) {
+    case message::BookAction::kAdd:
+    case message::BookAction::kModify:
+      SetLevel(side, price_ticks, quantity);
+      break;
+    case message::BookAction::kDelete:
+      SetLevel(side, price_ticks, 0);
+      break;
+  }
+}
+
+void OrderBook::SetLevel(Side side, std::int64_t price_ticks,
+                         std::int64_t quantity) {
+  if (InWindow(price_ticks)) {
+    SetIndex(side, price_ticks - base_, quantity);
+  } else if (quantity > 0) {
+    Book(side).overflow[price_ticks] = quantity;
+  } else {
+    Book(side).overflow.erase(price_ticks);
+  }
+
+  // Updates away from the touch leave the window where it is
+  if (TouchOutside(Side::kBid) || TouchOutside(Side::kAsk)) Recenter();
+}
+
+bool OrderBook::TouchOutside(Side side) const {
+  const SideBook& book = Book(side);
+  if (book.overflow.empty()) return false;
+  if (book.best < 0) return true;
+
+  const std::int64_t best = base_ + book.best;
+  return side == Side::kBid ? book.overflow.rbegin()->first > best
+                            : book.overflow.begin()->first < best;
+}
+
+void OrderBook::SetIndex(Side side, std::int64_t index,
+                         std::int64_t quantity) {
+  SideBook& book = Book(side);
+  std::uint64_t& word = book.occupied[index >> 6];
+  const std::uint64_t bit = 1ULL << (index & 63);
+
+  if (quantity > 0) {
+    book.quantity[index] = quantity;
+    if (word & bit) return;
+
+    word |= bit;
+    ++book.count;
+    if (book.best < 0 || (side == Side::kBid ? index > book.best
+                                             : index < book.best)) {
+      book.best = index;
+    }
+    return;
+  }
+
+  if (!(word & bit)) return;
+
+  book.quantity[index] = 0;
+  word &= ~bit;
+  --book.count;
+  if (index == book.best) {
+    book.best = side == Side::kBid ? FindPrevious(book, index - 1)
+                                   : FindNext(book, index + 1);
+  }
+}
+
+void OrderBook::Clear() {
+  ClearWindow(bids_);
+  ClearWindow(asks_);
+  bids_.overflow.clear();
+  asks_.overflow.clear();
+}
+
+void OrderBook::ClearWindow(SideBook& book) {
+  // Only touch occupied ticks instead of the whole window
+  for (std::size_t w = 0; w < book.occupied.size(); ++w) {
+    std::uint64_t bits = book.occupied[w];
+    while (bits) {
+      book.quantity[w * 64 + __builtin_ctzll(bits)] = 0;
+      bits &= bits - 1;
+    }
+    book.occupied[w] = 0;
+  }
+  book.best = -1;
+  book.count = 0;
+}
+
+bool OrderBook::BestBid(BookLevel& level) const {
+  return Best(Side::kBid, level);
+}
+
+bool OrderBook::BestAsk(BookLevel& level) const {
+  return Best(Side::kAsk, level);
+}
+
+bool OrderBook::Best(Side side, BookLevel& level) const {
+  const SideBook& book = Book(side);
+  const bool bid = side == Side::kBid;
+  bool found = false;
+
+  if (book.best >= 0) {
+    level.price_ticks = base_ + book.best;
+    level.quantity = book.quantity[book.best];
+    found = true;
+  }
+
+  // The touch is only outside the window while the spread is wider than it
+  if (!book.overflow.empty()) {
+    const auto& far = bid ? *book.overflow.rbegin() : *book.overflow.begin();
+    if (!found || (bid ? far.first > level.price_ticks
+                       : far.first < level.price_ticks)) {
+      level.price_ticks = far.first;
+      level.quantity = far.second;
+      found = true;
+    }
+  }
+  return found;
+}
+
+std::int64_t OrderBook::Quantity(Side side, std::int64_t price_ticks) const {
+  const SideBook& book = Book(side);
+  if (InWindow(price_ticks)) return book.quantity[price_ticks - base_];
+
+  auto it = book.overflow.find(price_ticks);
+  return it == book.overflow.end() ? 0 : it->second;
+}
+
+std::size_t OrderBook::Depth(Side side, std::size_t max_levels,
+                             std::vector<BookLevel>& out) const {
+  const SideBook& book = Book(side);
+  const std::int64_t top = base_ + static_cast<std::int64_t>(window_);
+  out.clear();
+
+  // Overflow levels better than the window come first, then the window,
+  // then the overflow levels behind it
+  auto add_overflow = [&](auto begin, auto end) {
+    for (auto it = begin; it != end && out.size() < max_levels; ++it) {
+      out.push_back({it->first, it->second});
+    }
+  };
+  auto add_window = [&]() {
+    std::int64_t index = book.best;
+    while (index >= 0 && out.size() < max_levels) {
+      out.push_back({base_ + index, book.quantity[index]});
+      index = side == Side::kBid ? FindPrevious(book, index - 1)
+                                 : FindNext(book, index + 1);
+    }
+  };
+
+  if (side == Side::kBid) {
+    const auto begin = book.overflow.rbegin();
+    auto behind = begin;
+    while (behind != book.overflow.rend() && behind->first >= top) ++behind;
+    add_overflow(begin, behind);
+    add_window();
+    add_overflow(behind, book.overflow.rend());
+  } else {
+    auto behind = book.overflow.lower_bound(base_);
+    add_overflow(book.overflow.begin(), behind);
+    add_window();
+    add_overflow(behind, book.overflow.end());
+  }
+  return out.size();
+}
+
+std::size_t OrderBook::LevelCount(Side side) const {
+  const SideBook& book = Book(side);
+  return book.count + book.overflow.size();
+}
+
+void OrderBook::Recenter() {
+  BookLevel bid, ask;
+  const bool has_bid = Best(Side::kBid, bid);
+  const bool has_ask = Best(Side::kAsk, ask);
+  if (!has_bid && !has_ask) return;
+
+  // Centre on the mid, or on the only side present
+  std::int64_t center;
+  if (has_bid && has_ask) {
+    center = bid.price_ticks + (ask.price_ticks - bid.price_ticks) / 2;
+  } else {
+    center = has_bid ? bid.price_ticks : ask.price_ticks;
+  }
+  const std::int64_t new_base = center - static_cast<std::int64_t>(window_ / 2);
+  if (new_base == base_) return;
+
+  // Move the window into the overflow maps, then take back the levels that
+  // fall into the new window
+  for (SideBook* book : {&bids_, &asks_}) {
+    for (std::size_t w = 0; w < book->occupied.size(); ++w) {
+      std::uint64_t bits = book->occupied[w];
+      while (bits) {
+        const std::size_t index = w * 64 + __builtin_ctzll(bits);
+        book->overflow[base_ + static_cast<std::int64_t>(index)] =
+            book->quantity[index];
+        bits &= bits - 1;
+      }
+    }
+    ClearWindow(*book);
+  }
+
+  base_ = new_base;
+  const std::int64_t top = base_ + static_cast<std::int64_t>(window_);
+  for (Side side : {Side::kBid, Side::kAsk}) {
+    SideBook& book = Book(side);
+    const auto first = book.overflow.lower_bound(base_);
+    const auto last = book.overflow.lower_bound(top);
+    for (auto it = first; it != last; ++it) {
+      SetIndex(side, it->first - base_, it->second);
+    }
+    book.overflow.erase(first, last);
+  }
+}
+
+std::int64_t OrderBook::FindPrevious(const SideBook& book, std::int64_t from) {
+  if (from < 0) return -1;
+
+  std::int64_t w = from >> 6;
+  std::uint64_t bits = book.occupied[w] & (~0ULL >> (63 - (from & 63)));
+  while (true) {
+    if (bits) return w * 64 + 63 - __builtin_clzll(bits);
+    if (--w < 0) return -1;
+    bits = book.occupied[w];
+  }
+}
+
+std::int64_t OrderBook::FindNext(const SideBook& book, std::int64_t from) {
+  std::size_t w = static_cast<std::size_t>(from >> 6);
+  if (w >= book.occupied.size()) return -1;
+
+  std::uint64_t bits = book.occupied[w] & (~0ULL << (from & 63));
+  while (true) {
+    if (bits) return static_cast<std::int64_t>(w * 64 + __builtin_ctzll(bits));
+    if (++w == book.occupied.size()) return -1;
+    bits = book.occupied[w];
+  }
+}
+
+}  // namespace book
+}  // namespace backtestx
@@ -0,0 +1,116 @@
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "util/CommandOptionParser.h"
+
+#include "BackTestX/results/results_reader.hpp"
+
+using namespace backtestx;
+using namespace aeron::util;
+
+static const char opt_help = 'h';
+static const char opt_file = 'f';
+static const char opt_type = 't';
+static const char opt_output = 'o';
+
+struct Settings {
+  std::string file_path;
+  std::string type;
+  std::string output_path;
+};
+
+Settings ParseCmdLine(CommandOptionParser& cp, int argc, char** argv) {
+  cp.parse(argc, argv);
+  if (cp.getOption(opt_help).isPresent()) {
+    cp.displayOptionsHelp(std::cout);
+    exit(EXIT_SUCCESS);
+  }
+
+  Settings s;
+
+  s.file_path = cp.getOption(opt_file).getParam(0, s.file_path);
+  s.type = cp.getOption(opt_type).getParam(0, s.type);
+  s.output_path = cp.getOption(opt_output).getParam(0, s.output_path);
+
+  return s;
+}
+
+// Print the number of blocks and records of each type
+void PrintSummary(results::ResultsReader& reader) {
+  std::uint64_t blocks[results::RECORD_TYPE_COUNT] = {};
+  std::uint64_t records[results::RECORD_TYPE_COUNT] = {};
+
+  results::ResultsBlock block;
+  while (reader.Next(block)) {
+    ++blocks[block.header.record_type];
+    records[block.header.record_type] += block.header.record_count;
+  }
+
+  for (std::size_t t = 0; t < results::RECORD_TYPE_COUNT; ++t) {
+    std::cout << results::RecordTypeName(static_cast<results::RecordType>(t))
+              << ": " << records[t] << " records in " << blocks[t]
+              << " blocks" << std::endl;
+  }
+}
+
+int main(int argc, char** argv) {
+  CommandOptionParser cp;
+  cp.addOption(CommandOption(opt_help, 0, 0, "Displays help information."));
+  cp.addOption(CommandOption(opt_file, 1, 1, "Results file to read."));
+  cp.addOption(CommandOption(opt_type, 1, 1,
+                             "Records to export: fills, orders or equity."));
+  cp.addOption(
+      CommandOption(opt_output, 1, 1, "CSV file to export to, or stdout."));
+
+  try {
+    Settings settings = ParseCmdLine(cp, argc, argv);
+
+    if (settings.file_path.empty()) {
+      std::ostringstream ErrorMsg;
+      ErrorMsg << "\n\nUsage: " + std::string(argv[0]) +
+                      " -f <filename> [-t <type>]\n\n"
+               << "Options:\n"
+               << "  -f, <filename>    Results file to read\n"
+               << "  -t, <type>        Export fills, orders or equity as CSV\n"
+               << "  -h,               Display help message";
+      throw std::runtime_error(ErrorMsg.str());
+    }
+
+    results::ResultsReader reader;
+    if (!reader.Open(settings.file_path)) return -1;
+
+    if (settings.type.empty()) {
+      PrintSummary(reader);
+      return 0;
+    }
+
+    results::RecordType type;
+    if (!results::ParseRecordType(settings.type.c_str(), type)) {
+      throw std::runtime_error("Unknown record type: " + settings.type);
+    }
+
+    if (settings.output_path.empty()) {
+      results::ExportCsv(reader, type, std::cout);
+    } else {
+      std::ofstream out(settings.output_path);
+      if (!out.is_open()) {
+        throw std::runtime_error("Failed to open " + settings.output_path);
+      }
+      const std::uint64_t count = results::ExportCsv(reader, type, out);
+      std::cout << "Exported " << count << " records to "
+                << settings.output_path << std::endl;
+    }
+  } catch (const CommandOptionException& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+    cp.displayOptionsHelp(std::cerr);
+    return -1;
+  } catch (const std::exception& e) {
+    std::cerr << "FAILED: " << e.what() << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,164 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "util/CommandOptionParser.h"
+
+#include "BackTestX/stats/counters.hpp"
+
+using namespace backtestx;
+using namespace aeron::util;
+
+std::atomic<bool> running(true);
+
+void SigIntHandler(int) { running = false; }
+
+static const char opt_help = 'h';
+static const char opt_file = 'f';
+static const char opt_pid = 'p';
+static const char opt_interval = 'i';
+
+static const int DEFAULT_INTERVAL_MS = 1000;
+
+struct Settings {
+  std::string file_path;
+  int pid = 0;
+  int interval_ms = DEFAULT_INTERVAL_MS;
+};
+
+Settings ParseCmdLine(CommandOptionParser& cp, int argc, char** argv) {
+  cp.parse(argc, argv);
+  if (cp.getOption(opt_help).isPresent()) {
+    cp.displayOptionsHelp(std::cout);
+    exit(EXIT_SUCCESS);
+  }
+
+  Settings s;
+
+  s.file_path = cp.getOption(opt_file).getParam(0, s.file_path);
+  s.pid = cp.getOption(opt_pid).getParamAsInt(0, 1, INT32_MAX, s.pid);
+  s.interval_ms = cp.getOption(opt_interval)
+                      .getParamAsInt(0, 1, 60 * 60 * 1000, s.interval_ms);
+
+  return s;
+}
+
+// Find the counters file of a running process in the default location, of
+// the given pid or else the only one running
+std::string FindCountersFile(int pid) {
+  std::vector<std::string> live;
+  std::vector<std::int32_t> pids;
+  for (const std::string& path : stats::ListCountersFiles()) {
+    stats::CountersFile file;
+    try {
+      file.Attach(path);
+    } catch (const std::exception&) {
+      continue;
+    }
+    const std::int32_t owner = file.Header()->pid;
+    if (pid != 0 ? owner == pid : stats::ProcessAlive(owner)) {
+      live.push_back(path);
+      pids.push_back(owner);
+    }
+  }
+
+  if (live.size() == 1) return live[0];
+  if (live.empty()) {
+    throw std::runtime_error(pid != 0 ? "No counters file for process " +
+                                            std::to_string(pid)
+                                      : "No running process with counters");
+  }
+
+  std::ostringstream message;
+  message << "Several processes have counters, choose one with -p or -f:";
+  for (std::size_t i = 0; i < live.size(); ++i) {
+    message << "\n  " << pids[i] << "  " << live[i];
+  }
+  throw std::runtime_error(message.str());
+}
+
+int main(int argc, char** argv) {
+  CommandOptionParser cp;
+  cp.addOption(CommandOption(opt_help, 0, 0, "Displays help information."));
+  cp.addOption(CommandOption(opt_file, 1, 1, "Counters file to attach to."));
+  cp.addOption(
+      CommandOption(opt_pid, 1, 1, "Process whose counters to attach to."));
+  cp.addOption(
+      CommandOption(opt_interval, 1, 1, "Refresh interval in milliseconds."));
+
+  try {
+    Settings settings = ParseCmdLine(cp, argc, argv);
+    if (settings.file_path.empty()) {
+      settings.file_path = FindCountersFile(settings.pid);
+    }
+
+    stats::CountersFile counters;
+    counters.Attach(settings.file_path);
+
+    const stats::CountersHeader* header = counters.Header();
+    const std::uint32_t count = counters.CounterCount();
+    const stats::CounterSlot* slots = counters.Slots();
+
+    std::cout << "Attached to " << settings.file_path << " (pid "
+              << header->pid << ", " << count << " counters)" << std::endl;
+
+    signal(SIGINT, SigIntHandler);
+
+    std::vector<std::uint64_t> previous(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+      previous[i] = slots[i].value.load(std::memory_order_relaxed);
+    }
+    auto previous_time = std::chrono::steady_clock::now();
+
+    while (running) {
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(settings.interval_ms));
+
+      // Checked before reading, so the counters printed last are final
+      const bool owner_alive = stats::ProcessAlive(header->pid);
+
+      const auto now = std::chrono::steady_clock::now();
+      const double seconds =
+          std::chrono::duration<double>(now - previous_time).count();
+      previous_time = now;
+
+      std::printf("%-36s %20s %16s\n", "Counter", "Value", "Rate/s");
+      for (std::uint32_t i = 0; i < count; ++i) {
+        const std::uint64_t value =
+            slots[i].value.load(std::memory_order_relaxed);
+        if (slots[i].kind == stats::kTotal) {
+          const double rate = (value - previous[i]) / seconds;
+          std::printf("%-36s %20llu %16.1f\n", slots[i].label,
+                      static_cast<unsigned long long>(value), rate);
+        } else {
+          std::printf("%-36s %20llu %16s\n", slots[i].label,
+                      static_cast<unsigned long long>(value), "-");
+        }
+        previous[i] = value;
+      }
+      std::printf("\n");
+      std::fflush(stdout);
+
+      if (!owner_alive) {
+        std::cout << "Process " << header->pid << " has exited" << std::endl;
+        break;
+      }
+    }
+  } catch (const CommandOptionException& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+    cp.displayOptionsHelp(std::cerr);
+    return -1;
+  } catch (const std::exception& e) {
+    std::cerr << "FAILED: " << e.what() << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
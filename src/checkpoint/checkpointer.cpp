@@ -0,0 +1,180 @@
+#include "BackTestX/checkpoint/checkpointer.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BackTestX/trace/trace.hpp"
+
+namespace backtestx {
+namespace checkpoint {
+
+namespace {
+
+template <typename T>
+void WriteColumn(std::ofstream& file, const std::vector<T>& column) {
+  file.write(reinterpret_cast<const char*>(column.data()),
+             static_cast<std::streamsize>(column.size() * sizeof(T)));
+}
+
+template <typename T>
+const char* ReadColumn(const char* src, std::size_t count,
+                       std::vector<T>& column) {
+  column.resize(count);
+  std::memcpy(column.data(), src, count * sizeof(T));
+  return src + count * sizeof(T);
+}
+
+std::size_t SnapshotSize(std::uint64_t bar_count) {
+  return sizeof(SnapshotHeader) +
+         bar_count * (5 * sizeof(double) + sizeof(std::int32_t));
+}
+
+}  // namespace
+
+void WriteSnapshot(const std::string& path, const BarColumns& bars,
+                   std::uint64_t next_row) {
+  BTX_TRACE_SCOPE("WriteSnapshot");
+  static_assert(sizeof(int) == sizeof(std::int32_t),
+                "Volume column is stored as 32-bit integers");
+
+  const std::string tmp_path = path + ".tmp";
+  std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    std::cerr << "Failed to open checkpoint file: " << tmp_path << std::endl;
+    return;
+  }
+
+  SnapshotHeader header{};
+  header.magic = SNAPSHOT_MAGIC;
+  header.version = SNAPSHOT_VERSION;
+  header.bar_count = bars.size();
+  header.next_row = next_row;
+  header.created_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  WriteColumn(file, bars.dates);
+  WriteColumn(file, bars.closes);
+  WriteColumn(file, bars.opens);
+  WriteColumn(file, bars.highs);
+  WriteColumn(file, bars.lows);
+  WriteColumn(file, bars.volumes);
+  file.close();
+
+  if (!file || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::cerr << "Failed to write checkpoint file: " << path << std::endl;
+  }
+}
+
+bool ReadSnapshot(const std::string& path, BarColumns& bars,
+                  std::uint64_t& next_row) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0 ||
+      static_cast<std::size_t>(st.st_size) < sizeof(SnapshotHeader)) {
+    ::close(fd);
+    return false;
+  }
+
+  const std::size_t length = static_cast<std::size_t>(st.st_size);
+  void* address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (address == MAP_FAILED) return false;
+
+  const char* src = static_cast<const char*>(address);
+  SnapshotHeader header;
+  std::memcpy(&header, src, sizeof(header));
+
+  const bool valid = header.magic == SNAPSHOT_MAGIC &&
+                     header.version == SNAPSHOT_VERSION &&
+                     length == SnapshotSize(header.bar_count);
+  if (valid) {
+    const std::size_t count = header.bar_count;
+    src += sizeof(SnapshotHeader);
+    src = ReadColumn(src, count, bars.dates);
+    src = ReadColumn(src, count, bars.closes);
+    src = ReadColumn(src, count, bars.opens);
+    src = ReadColumn(src, count, bars.highs);
+    src = ReadColumn(src, count, bars.lows);
+    ReadColumn(src, count, bars.volumes);
+    next_row = header.next_row;
+  } else {
+    std::cerr << "Ignoring invalid checkpoint file: " << path << std::endl;
+  }
+
+  ::munmap(address, length);
+  return valid;
+}
+
+Checkpointer::Checkpointer(std::shared_ptr<plot::DataHandler> data_handler,
+                           const std::string& path,
+                           std::chrono::milliseconds interval)
+    : data_handler_(data_handler),
+      path_(path),
+      interval_(interval),
+      stop_requested_(false),
+      next_row_(0),
+      written_count_(0) {}
+
+Checkpointer::~Checkpointer() { Stop(); }
+
+std::size_t Checkpointer::Restore(std::uint64_t& next_row) {
+  BarColumns bars;
+  next_row = 0;
+  if (!ReadSnapshot(path_, bars, next_row)) return 0;
+
+  // The restored bars are already on disk, keep a copy as the baseline
+  bars_ = bars;
+  next_row_ = next_row;
+  written_count_ = bars_.size();
+
+  data_handler_->RestoreBars(std::move(bars), next_row);
+  return written_count_;
+}
+
+void Checkpointer::Start() {
+  stop_requested_ = false;
+  thread_ = std::thread(&Checkpointer::CheckpointThread, this);
+}
+
+void Checkpointer::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_requested_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) thread_.join();
+}
+
+void Checkpointer::CheckpointThread() {
+  BTX_TRACE_THREAD_NAME("checkpoint");
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_requested_) {
+    cv_.wait_for(lock, interval_, [this] { return stop_requested_; });
+    lock.unlock();
+    Checkpoint();
+    lock.lock();
+  }
+}
+
+void Checkpointer::Checkpoint() {
+  const std::size_t count =
+      data_handler_->CopyBarsSince(bars_.size(), bars_, next_row_);
+  if (count == written_count_) return;
+
+  WriteSnapshot(path_, bars_, next_row_);
+  written_count_ = count;
+}
+
+}  // namespace checkpoint
+}  // namespace backtestx
@@ -3,10 +3,13 @@
 #include <algorithm>
 #include <cctype>
 
+#include "BackTestX/trace/trace.hpp"
+
 namespace backtestx {
 CsvReader::CsvReader() {}
 
 CsvReader::CsvData CsvReader::ReadCSV(const std::string& filename) {
+  BTX_TRACE_SCOPE("ReadCSV");
   std::ifstream file(filename);
 
   if (!file.is_open()) {
@@ -0,0 +1,152 @@
+#include "BackTestX/csv_stream_reader.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <sstream>
+
+#include "BackTestX/stats/counters.hpp"
+#include "BackTestX/trace/trace.hpp"
+
+namespace backtestx {
+CsvStreamReader::CsvStreamReader() {}
+
+bool CsvStreamReader::Open(const std::string& filename) {
+  file_.open(filename);
+
+  if (!file_.is_open()) {
+    std::cerr << "Failed to open file: " << filename << std::endl;
+    return false;
+  }
+
+  // Read the header line
+  headers_.clear();
+  if (std::getline(file_, line_)) {
+    std::stringstream ss(line_);
+    std::string cell;
+    while (std::getline(ss, cell, ',')) {
+      cell.erase(std::remove_if(cell.begin(), cell.end(),
+                                [](unsigned char c) {
+                                  return std::iscntrl(c) || std::isspace(c);
+                                }),
+                 cell.end());
+      headers_.push_back(cell);
+    }
+  }
+  return true;
+}
+
+int CsvStreamReader::ColumnIndex(const std::string& header) const {
+  auto it = std::find(headers_.begin(), headers_.end(), header);
+  return it == headers_.end() ? -1 : static_cast<int>(it - headers_.begin());
+}
+
+std::size_t CsvStreamReader::ReadChunk(Chunk& chunk, std::size_t max_rows) {
+  BTX_TRACE_SCOPE("ReadChunk");
+  chunk.Clear();
+  chunk.columns = headers_.size();
+
+  while (chunk.rows < max_rows && std::getline(file_, line_)) {
+    const std::uint32_t base = static_cast<std::uint32_t>(chunk.text.size());
+    chunk.text.append(line_);
+
+    // Record the cells of the row, padding missing ones with empty cells
+    std::size_t column = 0;
+    std::size_t begin = 0;
+    while (column < chunk.columns) {
+      std::size_t end = line_.find(',', begin);
+      if (end == std::string::npos) end = line_.size();
+      chunk.offsets.push_back(base + static_cast<std::uint32_t>(begin));
+      chunk.offsets.push_back(base + static_cast<std::uint32_t>(end));
+      ++column;
+      begin = std::min(end + 1, line_.size());
+    }
+    ++chunk.rows;
+  }
+  return chunk.rows;
+}
+
+ReadAheadReader::ReadAheadReader(std::size_t chunk_rows,
+                                 std::size_t chunk_count)
+    : chunk_rows_(std::max<std::size_t>(1, chunk_rows)),
+      end_of_file_(false),
+      stop_requested_(false) {
+  for (std::size_t i = 0; i < std::max<std::size_t>(2, chunk_count); ++i) {
+    chunks_.push_back(std::make_unique<CsvStreamReader::Chunk>());
+    free_.push_back(chunks_.back().get());
+  }
+}
+
+ReadAheadReader::~ReadAheadReader() { Stop(); }
+
+bool ReadAheadReader::Open(const std::string& filename) {
+  return reader_.Open(filename);
+}
+
+void ReadAheadReader::Start() {
+  thread_ = std::thread(&ReadAheadReader::ReaderThread, this);
+}
+
+CsvStreamReader::Chunk* ReadAheadReader::Acquire() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this] {
+    return !filled_.empty() || end_of_file_ || stop_requested_;
+  });
+  if (filled_.empty()) return nullptr;
+
+  CsvStreamReader::Chunk* chunk = filled_.front();
+  filled_.pop_front();
+  stats::Set(stats::kReadAheadChunks, filled_.size());
+  return chunk;
+}
+
+void ReadAheadReader::Release(CsvStreamReader::Chunk* chunk) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(chunk);
+  }
+  cv_.notify_all();
+}
+
+void ReadAheadReader::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_requested_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) thread_.join();
+}
+
+void ReadAheadReader::ReaderThread() {
+  BTX_TRACE_THREAD_NAME("csv reader");
+  while (true) {
+    CsvStreamReader::Chunk* chunk;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return !free_.empty() || stop_requested_; });
+      if (stop_requested_) return;
+      chunk = free_.front();
+      free_.pop_front();
+    }
+
+    // Parse outside the lock so the consumer keeps going meanwhile
+    const std::size_t rows = reader_.ReadChunk(*chunk, chunk_rows_);
+
+    bool done = rows < chunk_rows_;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (rows > 0) {
+        filled_.push_back(chunk);
+        stats::Set(stats::kReadAheadChunks, filled_.size());
+      } else {
+        free_.push_back(chunk);
+      }
+      end_of_file_ = done;
+    }
+    cv_.notify_all();
+
+    if (done) return;
+  }
+}
+
+}  // namespace backtestx
@@ -1,11 +1,17 @@
 #include "BackTestX/graphical/gui.hpp"
 
+#include <chrono>
+
 #include "BackTestX/plot/candlestick.hpp"
+#include "BackTestX/plot/depth_heatmap.hpp"
+#include "BackTestX/stats/counters.hpp"
+#include "BackTestX/trace/trace.hpp"
 
 namespace backtestx {
 namespace graphical {
 
-GUI::GUI() : keep_running_(false), data_handler_(nullptr) {}
+GUI::GUI()
+    : keep_running_(false), data_handler_(nullptr), book_store_(nullptr) {}
 
 GUI::~GUI() {
   keep_running_ = false;
@@ -22,8 +28,13 @@ void GUI::SetDataHandler(std::shared_ptr<plot::DataHandler> data_handler) {
   data_handler_ = data_handler;
 }
 
+void GUI::SetBookStore(std::shared_ptr<book::BookStore> book_store) {
+  book_store_ = book_store;
+}
+
 void GUI::GUIThread() {
   keep_running_ = true;
+  BTX_TRACE_THREAD_NAME("gui");
 
   // Setup window
   glfwSetErrorCallback(GlfwErrorCallback);
@@ -61,10 +72,12 @@ void GUI::GUIThread() {
   ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
 
   plot::Candlestick candlestick;
+  plot::DepthHeatmap depth_heatmap;
 
   // Main loop
   while (keep_running_ && !glfwWindowShouldClose(window)) {
     glfwPollEvents();
+    const auto frame_start = std::chrono::steady_clock::now();
 
     // Start the Dear ImGui frame
     ImGui_ImplOpenGL3_NewFrame();
@@ -81,6 +94,9 @@ void GUI::GUIThread() {
     // Render the stock chart
     candlestick.RenderStockChart(data_handler_);
 
+    // Render the order book depth, if any book data has arrived
+    depth_heatmap.RenderDepthHeatmap(book_store_);
+
     ImGui::End();
 
     // Rendering
@@ -93,7 +109,15 @@ void GUI::GUIThread() {
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
     // Swap buffers
-    glfwSwapBuffers(window);
+    {
+      BTX_TRACE_SCOPE("SwapBuffers");
+      glfwSwapBuffers(window);
+    }
+
+    stats::Set(stats::kGuiFrameTimeNs,
+               std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - frame_start)
+                   .count());
   }
 
   // Cleanup
@@ -0,0 +1,235 @@
+#include "BackTestX/message/bar_batch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace backtestx {
+namespace message {
+
+namespace {
+
+std::uint64_t ReadVarintChecked(const std::uint8_t*& p, const std::uint8_t* end,
+                                bool& ok) {
+  std::uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (p == end) break;
+    const std::uint8_t byte = *p++;
+    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return value;
+  }
+  ok = false;
+  return 0;
+}
+
+// Varint reader without bounds checks, for bars that cannot run past the end
+// of the message. Small deltas dominate, so the loop usually exits on the
+// first byte and the branch predicts well.
+std::uint64_t ReadVarintUnchecked(const std::uint8_t*& p,
+                                  const std::uint8_t*, bool& ok) {
+  std::uint64_t value = 0;
+  std::uint8_t byte;
+  int shift = 0;
+  do {
+    byte = *p++;
+    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    shift += 7;
+  } while ((byte & 0x80) && shift < 70);
+  if (byte & 0x80) ok = false;
+  return value;
+}
+
+// Running values of a symbol and the columns being filled
+struct DecodeCursor {
+  std::int64_t date;
+  std::int64_t close;
+  std::int64_t volume;
+  double ticks_per_unit;
+  double* dates;
+  double* closes;
+  int* volumes;
+  double* opens;
+  double* highs;
+  double* lows;
+};
+
+template <bool Checked>
+std::int64_t ReadDelta(const std::uint8_t*& p, const std::uint8_t* end,
+                       bool& ok) {
+  return ZigZagDecode(Checked ? ReadVarintChecked(p, end, ok)
+                              : ReadVarintUnchecked(p, end, ok));
+}
+
+template <bool Checked>
+void DecodeBar(const std::uint8_t*& p, const std::uint8_t* end,
+               std::size_t i, DecodeCursor& c, bool& ok) {
+  c.date += ReadDelta<Checked>(p, end, ok);
+  c.close += ReadDelta<Checked>(p, end, ok);
+  c.volume += ReadDelta<Checked>(p, end, ok);
+  const std::int64_t open = c.close + ReadDelta<Checked>(p, end, ok);
+  const std::int64_t high = c.close + ReadDelta<Checked>(p, end, ok);
+  const std::int64_t low = c.close + ReadDelta<Checked>(p, end, ok);
+
+  // Dividing exact integers rounds the same way as parsing the decimal text
+  c.dates[i] = static_cast<double>(c.date);
+  c.closes[i] = static_cast<double>(c.close) / c.ticks_per_unit;
+  c.volumes[i] = static_cast<int>(c.volume);
+  c.opens[i] = static_cast<double>(open) / c.ticks_per_unit;
+  c.highs[i] = static_cast<double>(high) / c.ticks_per_unit;
+  c.lows[i] = static_cast<double>(low) / c.ticks_per_unit;
+}
+
+}  // namespace
+
+BarBatchEncoder::BarBatchEncoder(std::uint32_t symbol_id,
+                                 std::size_t batch_size, int price_decimals,
+                                 std::size_t keyframe_interval)
+    : symbol_id_(symbol_id),
+      batch_size_(std::min<std::size_t>(std::max<std::size_t>(1, batch_size),
+                                        UINT16_MAX)),
+      ticks_per_unit_(std::pow(10.0, std::min(std::max(price_decimals, 0), 9))),
+      keyframe_interval_(std::max<std::size_t>(1, keyframe_interval)),
+      sequence_(0),
+      count_(0),
+      body_(batch_size_ * BAR_BATCH_FIELDS * MAX_VARINT_LENGTH),
+      body_length_(0),
+      last_row_(0),
+      date_(0),
+      close_(0),
+      volume_(0) {}
+
+std::size_t BarBatchEncoder::MaxLength() const {
+  return sizeof(BarBatchHeader) + body_.size();
+}
+
+bool BarBatchEncoder::Add(double date, double close, std::int64_t volume,
+                          double open, double high, double low,
+                          std::uint64_t row) {
+  // Keyframes encode their first bar against zero
+  if (count_ == 0 && IsKeyframe()) {
+    date_ = 0;
+    close_ = 0;
+    volume_ = 0;
+  }
+
+  const std::int64_t date_seconds = std::llround(date);
+  const std::int64_t close_ticks = std::llround(close * ticks_per_unit_);
+  Put(date_seconds - date_);
+  Put(close_ticks - close_);
+  Put(volume - volume_);
+  Put(std::llround(open * ticks_per_unit_) - close_ticks);
+  Put(std::llround(high * ticks_per_unit_) - close_ticks);
+  Put(std::llround(low * ticks_per_unit_) - close_ticks);
+
+  date_ = date_seconds;
+  close_ = close_ticks;
+  volume_ = volume;
+  last_row_ = row;
+  return ++count_ == batch_size_;
+}
+
+std::size_t BarBatchEncoder::Finish(std::uint8_t* out) {
+  if (count_ == 0) return 0;
+
+  BarBatchHeader header{};
+  header.type = static_cast<std::uint8_t>(MessageType::kBarBatch);
+  header.flags = IsKeyframe() ? BAR_BATCH_KEYFRAME : 0;
+  header.bar_count = static_cast<std::uint16_t>(count_);
+  header.symbol_id = symbol_id_;
+  header.sequence = sequence_;
+  header.ticks_per_unit = static_cast<std::uint32_t>(ticks_per_unit_);
+  header.last_row = last_row_;
+  WriteMessage(out, header);
+  std::memcpy(out + sizeof(header), body_.data(), body_length_);
+
+  const std::size_t length = sizeof(header) + body_length_;
+  ++sequence_;
+  count_ = 0;
+  body_length_ = 0;
+  return length;
+}
+
+void BarBatchEncoder::Put(std::int64_t delta) {
+  std::uint64_t value = ZigZagEncode(delta);
+  while (value >= 0x80) {
+    body_[body_length_++] = static_cast<std::uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  body_[body_length_++] = static_cast<std::uint8_t>(value);
+}
+
+BarBatchDecoder::BarBatchDecoder() : dropped_batches_(0) {}
+
+std::size_t BarBatchDecoder::Decode(const std::uint8_t* data,
+                                    std::size_t length, BarColumns& bars) {
+  if (length < sizeof(BarBatchHeader)) {
+    ++dropped_batches_;
+    return 0;
+  }
+
+  const auto header = ReadMessage<BarBatchHeader>(data);
+  if (header.type != static_cast<std::uint8_t>(MessageType::kBarBatch) ||
+      header.ticks_per_unit == 0) {
+    ++dropped_batches_;
+    return 0;
+  }
+
+  SymbolState& state = symbols_[header.symbol_id];
+  if (header.flags & BAR_BATCH_KEYFRAME) {
+    state.synced = true;
+    state.date = 0;
+    state.close = 0;
+    state.volume = 0;
+  } else if (!state.synced || header.sequence != state.next_sequence) {
+    state.synced = false;
+    ++dropped_batches_;
+    return 0;
+  }
+
+  // Decode straight into the columns
+  const std::size_t first = bars.size();
+  const std::size_t count = header.bar_count;
+  bars.resize(first + count);
+
+  DecodeCursor cursor;
+  cursor.date = state.date;
+  cursor.close = state.close;
+  cursor.volume = state.volume;
+  cursor.ticks_per_unit = header.ticks_per_unit;
+  cursor.dates = bars.dates.data() + first;
+  cursor.closes = bars.closes.data() + first;
+  cursor.volumes = bars.volumes.data() + first;
+  cursor.opens = bars.opens.data() + first;
+  cursor.highs = bars.highs.data() + first;
+  cursor.lows = bars.lows.data() + first;
+
+  const std::uint8_t* p = data + sizeof(header);
+  const std::uint8_t* end = data + length;
+  bool ok = true;
+
+  // Check the bounds once per bar while a bar of maximum length still fits,
+  // and per byte only for the last few bars
+  const std::size_t max_bar_length = BAR_BATCH_FIELDS * MAX_VARINT_LENGTH;
+  std::size_t i = 0;
+  for (; i < count && static_cast<std::size_t>(end - p) >= max_bar_length;
+       ++i) {
+    DecodeBar<false>(p, end, i, cursor, ok);
+  }
+  for (; i < count; ++i) DecodeBar<true>(p, end, i, cursor, ok);
+
+  if (!ok || p != end) {
+    bars.resize(first);
+    state.synced = false;
+    ++dropped_batches_;
+    return 0;
+  }
+
+  state.date = cursor.date;
+  state.close = cursor.close;
+  state.volume = cursor.volume;
+  state.next_sequence = header.sequence + 1;
+  return count;
+}
+
+}  // namespace message
+}  // namespace backtestx
@@ -1,5 +1,7 @@
 #include "BackTestX/plot/candlestick.hpp"
 
+#include "BackTestX/trace/trace.hpp"
+
 namespace backtestx {
 namespace plot {
 Candlestick::Candlestick() {}
@@ -17,6 +19,7 @@ int Candlestick::BinarySearch(const T* arr, int l, int r, T x) {
 
 void Candlestick::RenderStockChart(
     std::shared_ptr<DataHandler>& data_handler_) {
+  BTX_TRACE_SCOPE("RenderStockChart");
   if (!data_handler_) {
     std::cerr << "Data handler is not set!" << std::endl;
     return;
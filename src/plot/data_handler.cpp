@@ -3,20 +3,30 @@
 #include <sstream>
 #include <algorithm>
 
+#include "BackTestX/stats/counters.hpp"
+#include "BackTestX/trace/trace.hpp"
+
 namespace backtestx {
 namespace plot {
-DataHandler::DataHandler() {}
+DataHandler::DataHandler()
+    : data_ready_(false),
+      next_row_(0),
+      resume_after_date_(0),
+      resuming_(false),
+      has_symbol_(false),
+      symbol_id_(0) {}
 DataHandler::~DataHandler() {}
 
 void DataHandler::ProcessData(const std::string& data) {
+  BTX_TRACE_SCOPE("ProcessData");
   std::lock_guard<std::mutex> lock(data_mutex_);
 
   std::stringstream ss(data);
-  std::string date, volume, close, open, high, low;
+  std::string date, volume, close, open, high, low, row;
 
   if (std::getline(ss, date, ',') && std::getline(ss, close, ',') &&
       std::getline(ss, volume, ',') && std::getline(ss, open, ',') &&
-      std::getline(ss, high, ',') && std::getline(ss, low)) {
+      std::getline(ss, high, ',') && std::getline(ss, low, ',')) {
     auto remove_dollar = [](std::string& str) {
       str.erase(std::remove(str.begin(), str.end(), '$'), str.end());
     };
@@ -35,45 +45,148 @@ void DataHandler::ProcessData(const std::string& data) {
       stock_data.high = std::stod(high);
       stock_data.low = std::stod(low);
 
-      dates_.push_back(stock_data.date);
-      closes_.push_back(stock_data.close);
-      volumes_.push_back(stock_data.volume);
-      opens_.push_back(stock_data.open);
-      highs_.push_back(stock_data.high);
-      lows_.push_back(stock_data.low);
+      next_row_ = std::getline(ss, row) ? std::stoull(row) + 1 : next_row_ + 1;
+
+      // Skip bars already restored from a checkpoint
+      if (resuming_) {
+        if (stock_data.date <= resume_after_date_) return;
+        resuming_ = false;
+      }
+
+      bars_.Append(stock_data.date, stock_data.close, stock_data.volume,
+                   stock_data.open, stock_data.high, stock_data.low);
+      stats::Set(stats::kStoreSize, bars_.size());
+
+      if (bar_listener_) bar_listener_->OnBar(bars_, bars_.size() - 1);
 
       data_ready_ = true;
     } catch (const std::exception& e) {
+      stats::Increment(stats::kParseErrors);
       std::cerr << "Error processing data: " << e.what() << std::endl;
     }
   } else {
+    stats::Increment(stats::kParseErrors);
     std::cerr << "Error parsing data: " << data << std::endl;
   }
 }
 
+void DataHandler::ProcessBatch(const std::uint8_t* data,
+                               std::size_t length) {
+  BTX_TRACE_SCOPE("ProcessBatch");
+  std::lock_guard<std::mutex> lock(data_mutex_);
+
+  // The store holds the bars of one symbol, the first one decoded. Batches
+  // of other symbols are dropped before they reach the decoder.
+  if (has_symbol_ && length >= sizeof(message::BarBatchHeader) &&
+      message::ReadMessage<message::BarBatchHeader>(data).symbol_id !=
+          symbol_id_) {
+    stats::Increment(stats::kBarBatchesDropped);
+    return;
+  }
+
+  const std::size_t first = bars_.size();
+  const std::uint64_t dropped = batch_decoder_.DroppedBatches();
+  const std::size_t count = batch_decoder_.Decode(data, length, bars_);
+  if (count == 0) {
+    stats::Add(stats::kBarBatchesDropped,
+               batch_decoder_.DroppedBatches() - dropped);
+    return;
+  }
+
+  const auto header = message::ReadMessage<message::BarBatchHeader>(data);
+  has_symbol_ = true;
+  symbol_id_ = header.symbol_id;
+  next_row_ = header.last_row + 1;
+
+  // Skip bars already restored from a checkpoint
+  if (resuming_) {
+    std::size_t keep = first;
+    while (keep < bars_.size() && bars_.dates[keep] <= resume_after_date_) {
+      ++keep;
+    }
+    if (keep > first) {
+      auto erase = [first, keep](auto& column) {
+        column.erase(column.begin() + first, column.begin() + keep);
+      };
+      erase(bars_.dates);
+      erase(bars_.closes);
+      erase(bars_.volumes);
+      erase(bars_.opens);
+      erase(bars_.highs);
+      erase(bars_.lows);
+    }
+    if (bars_.size() == first) return;
+    resuming_ = false;
+  }
+
+  stats::Set(stats::kStoreSize, bars_.size());
+
+  if (bar_listener_) {
+    for (std::size_t i = first; i < bars_.size(); ++i) {
+      bar_listener_->OnBar(bars_, i);
+    }
+  }
+
+  data_ready_ = true;
+}
+
 bool DataHandler::GetDataReadyFlag() const { return data_ready_.load(); }
 
 void DataHandler::ResetDataReadyFlag() { data_ready_ = false; }
 
 std::vector<StockData> DataHandler::GetStockData() {
+  BTX_TRACE_SCOPE("GetStockData");
   std::lock_guard<std::mutex> lock(data_mutex_);
 
   std::vector<StockData> result;
-  size_t size = dates_.size();
+  size_t size = bars_.size();
 
   for (size_t i = 0; i < size; ++i) {
     StockData data;
-    data.date = dates_[i];
-    data.close = closes_[i];
-    data.volume = volumes_[i];
-    data.open = opens_[i];
-    data.high = highs_[i];
-    data.low = lows_[i];
+    data.date = bars_.dates[i];
+    data.close = bars_.closes[i];
+    data.volume = bars_.volumes[i];
+    data.open = bars_.opens[i];
+    data.high = bars_.highs[i];
+    data.low = bars_.lows[i];
     result.push_back(data);
   }
 
   return result;
 }
 
+std::size_t DataHandler::CopyBarsSince(std::size_t from, BarColumns& out,
+                                       std::uint64_t& next_row) {
+  std::lock_guard<std::mutex> lock(data_mutex_);
+
+  const std::size_t size = bars_.size();
+  if (from < size) out.Append(bars_, from, size);
+  next_row = next_row_;
+  return size;
+}
+
+void DataHandler::RestoreBars(BarColumns&& bars, std::uint64_t next_row) {
+  std::lock_guard<std::mutex> lock(data_mutex_);
+
+  bars_ = std::move(bars);
+  next_row_ = next_row;
+  resuming_ = !bars_.empty();
+  resume_after_date_ = resuming_ ? bars_.dates.back() : 0;
+  stats::Set(stats::kStoreSize, bars_.size());
+
+  if (resuming_) data_ready_ = true;
+}
+
+void DataHandler::SetBarListener(
+    std::shared_ptr<strategy::BarListener> listener) {
+  std::lock_guard<std::mutex> lock(data_mutex_);
+  bar_listener_ = listener;
+  if (bar_listener_) {
+    for (std::size_t i = 0; i < bars_.size(); ++i) {
+      bar_listener_->OnBar(bars_, i);
+    }
+  }
+}
+
 }  // namespace plot
 }  // namespace backtestx
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "BackTestX/plot/depth_heatmap.hpp"
+
+#include <algorithm>
+#include <string>
+
+#include "BackTestX/trace/trace.hpp"
+
+namespace backtestx {
+namespace plot {
+DepthHeatmap::DepthHeatmap()
+    : values_(2 * LEVELS * HISTORY, 0.0),
+      symbol_id_(0),
+      has_symbol_(false),
+      last_sample_time_(0) {}
+
+void DepthHeatmap::Sample(book::BookStore& book_store) {
+  // Scroll every row one sample to the left
+  for (int row = 0; row < 2 * LEVELS; ++row) {
+    double* values = values_.data() + row * HISTORY;
+    std::copy(values + 1, values + HISTORY, values);
+    values[HISTORY - 1] = 0.0;
+  }
+
+  if (!book_store.GetDepth(symbol_id_, LEVELS, bids_, asks_)) return;
+
+  // Row 0 is drawn at the top: the furthest ask first, the furthest bid last
+  for (std::size_t i = 0; i < asks_.size(); ++i) {
+    values_[(LEVELS - 1 - i) * HISTORY + HISTORY - 1] =
+        static_cast<double>(asks_[i].quantity);
+  }
+  for (std::size_t i = 0; i < bids_.size(); ++i) {
+    values_[(LEVELS + i) * HISTORY + HISTORY - 1] =
+        static_cast<double>(bids_[i].quantity);
+  }
+}
+
+void DepthHeatmap::RenderDepthHeatmap(
+    std::shared_ptr<book::BookStore>& book_store_) {
+  BTX_TRACE_SCOPE("RenderDepthHeatmap");
+  if (!book_store_) return;
+
+  std::vector<std::uint32_t> symbols = book_store_->GetSymbols();
+  if (symbols.empty()) return;
+
+  if (!has_symbol_) {
+    symbol_id_ = symbols.front();
+    has_symbol_ = true;
+  }
+
+  // Symbol selection
+  const std::string preview = "Symbol " + std::to_string(symbol_id_);
+  if (ImGui::BeginCombo("Order book", preview.c_str())) {
+    for (std::uint32_t symbol : symbols) {
+      const std::string label = "Symbol " + std::to_string(symbol);
+      if (ImGui::Selectable(label.c_str(), symbol == symbol_id_) &&
+          symbol != symbol_id_) {
+        symbol_id_ = symbol;
+        std::fill(values_.begin(), values_.end(), 0.0);
+      }
+    }
+    ImGui::EndCombo();
+  }
+
+  const double now = ImGui::GetTime();
+  if (now - last_sample_time_ >= SAMPLE_INTERVAL_S) {
+    last_sample_time_ = now;
+    Sample(*book_store_);
+  }
+
+  if (ImPlot::BeginPlot("Depth Heatmap", ImVec2(-1, 0))) {
+    ImPlot::SetupAxes("Time (s)", "Levels from touch",
+                      ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+    ImPlot::PushColormap(ImPlotColormap_Viridis);
+    // Zero scale limits let ImPlot fit the colour scale to the data
+    ImPlot::PlotHeatmap("Depth", values_.data(), 2 * LEVELS, HISTORY, 0, 0,
+                        nullptr,
+                        ImPlotPoint(-HISTORY * SAMPLE_INTERVAL_S, -LEVELS),
+                        ImPlotPoint(0, LEVELS));
+    ImPlot::PopColormap();
+    ImPlot::EndPlot();
+  }
+}
+
+}  // namespace plot
+}  // namespace backtestx
@@ -1,18 +1,29 @@
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <csignal>
 #include <cstdint>
 #include <cstdio>
 #include <cinttypes>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <string>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include "Aeron.h"
 #include "util/CommandOptionParser.h"
 
-#include "BackTestX/csv_reader.hpp"
+#include "BackTestX/book/order_book.hpp"
+#include "BackTestX/csv_stream_reader.hpp"
 #include "BackTestX/config/aeron_config.hpp"
+#include "BackTestX/message/bar_batch.hpp"
+#include "BackTestX/message/book_message.hpp"
+#include "BackTestX/stats/counters.hpp"
+#include "BackTestX/trace/trace.hpp"
 
 using namespace backtestx;
 using namespace aeron;
@@ -28,6 +39,14 @@ static const char opt_channel = 'c';
 static const char opt_stream_id = 's';
 static const char opt_linger = 'l';
 static const char opt_file = 'f';
+static const char opt_counters = 'm';
+static const char opt_offset = 'o';
+static const char opt_tick_size = 't';
+static const char opt_compress = 'z';
+static const char opt_batch_size = 'b';
+static const char opt_price_decimals = 'd';
+static const char opt_keyframe_interval = 'k';
+static const char opt_snapshot_interval = 'n';
 
 struct Settings {
   std::string dir_prefix;
@@ -35,9 +54,39 @@ struct Settings {
   std::int32_t stream_id = configuration::DEFAULT_STREAM_ID;
   int linger_timeout_ms = configuration::DEFAULT_LINGER_TIMEOUT_MS;
   std::string file_path;
+  std::string counters_path = stats::DefaultCountersPath("publisher");
+  int row_offset = 0;
+  double tick_size = configuration::DEFAULT_TICK_SIZE;
+  bool compress = false;
+  int batch_size = configuration::DEFAULT_BAR_BATCH_SIZE;
+  int price_decimals = configuration::DEFAULT_PRICE_DECIMALS;
+  int keyframe_interval = configuration::DEFAULT_KEYFRAME_INTERVAL;
+  int snapshot_interval = configuration::DEFAULT_SNAPSHOT_INTERVAL;
+};
+
+static const std::size_t READ_AHEAD_CHUNK_ROWS = 4096;
+static const std::size_t READ_AHEAD_CHUNKS = 4;
+
+// Interval between bars of the simulated live feed
+static const std::chrono::milliseconds BAR_INTERVAL(15);
+
+// Columns published for each bar, in message order
+static const std::array<const char*, 6> BAR_COLUMNS = {
+    "Date", "Close/Last", "Volume", "Open", "High", "Low"};
+
+// Columns of an order book update file. Action is A(dd), M(odify) or
+// D(elete) and Side is B(id) or A(sk).
+static const std::array<const char*, 6> BOOK_COLUMNS = {
+    "Timestamp", "Symbol", "Action", "Side", "Price", "Quantity"};
+
+// Book of a symbol as sent so far, from which snapshots are taken
+struct BookFeed {
+  book::OrderBook book;
+  std::uint32_t sequence = 0;
 };
 
 typedef std::array<std::uint8_t, 256> buffer_t;
+typedef std::array<int, BAR_COLUMNS.size()> column_map_t;
 
 Settings ParseCmdLine(CommandOptionParser& cp, int argc, char** argv) {
   cp.parse(argc, argv);
@@ -56,16 +105,215 @@ Settings ParseCmdLine(CommandOptionParser& cp, int argc, char** argv) {
       cp.getOption(opt_linger)
           .getParamAsInt(0, 0, 60 * 60 * 1000, s.linger_timeout_ms);
   s.file_path = cp.getOption(opt_file).getParam(0, s.file_path);
+  s.counters_path = cp.getOption(opt_counters).getParam(0, s.counters_path);
+  s.row_offset =
+      cp.getOption(opt_offset).getParamAsInt(0, 0, INT32_MAX, s.row_offset);
+  s.tick_size = std::stod(cp.getOption(opt_tick_size)
+                              .getParam(0, std::to_string(s.tick_size)));
+  if (!(s.tick_size > 0)) {
+    throw std::runtime_error("Tick size must be positive");
+  }
+  s.compress = cp.getOption(opt_compress).isPresent();
+  s.batch_size =
+      cp.getOption(opt_batch_size).getParamAsInt(0, 1, 4096, s.batch_size);
+  s.price_decimals = cp.getOption(opt_price_decimals)
+                         .getParamAsInt(0, 0, 9, s.price_decimals);
+  s.keyframe_interval =
+      cp.getOption(opt_keyframe_interval)
+          .getParamAsInt(0, 1, INT32_MAX, s.keyframe_interval);
+  s.snapshot_interval =
+      cp.getOption(opt_snapshot_interval)
+          .getParamAsInt(0, 1, INT32_MAX, s.snapshot_interval);
 
   return s;
 }
 
+// Encode the published columns of a row as comma separated text, followed by
+// the row's index in the source file so a subscriber can tell where to resume.
+// Returns the encoded length, which is cut short if the row does not fit the
+// buffer.
+std::size_t EncodeRow(const CsvStreamReader::Chunk& chunk, std::size_t row,
+                      std::size_t row_index, const column_map_t& columns,
+                      buffer_t& buffer, std::size_t& row_size) {
+  std::size_t length = 0;
+  row_size = 0;
+  auto put = [&](std::string_view cell) {
+    const std::size_t n = std::min(cell.size(), buffer.size() - length);
+    std::memcpy(buffer.data() + length, cell.data(), n);
+    length += n;
+    row_size += cell.size();
+  };
+  for (std::size_t i = 0; i < columns.size(); ++i) {
+    if (i > 0) put(",");
+    put(chunk.Cell(row, columns[i]));
+  }
+  put("," + std::to_string(row_index));
+  return length;
+}
+
+// Parse the published columns of a bar row and add the bar to a compressed
+// batch, setting full when the batch is ready to send. Returns false if the
+// row is malformed.
+bool AddBarRow(const CsvStreamReader::Chunk& chunk, std::size_t row,
+               std::size_t row_index, const column_map_t& columns,
+               message::BarBatchEncoder& encoder, bool& full) {
+  double values[BAR_COLUMNS.size()];
+  for (std::size_t i = 0; i < columns.size(); ++i) {
+    std::string cell(chunk.Cell(row, columns[i]));
+    cell.erase(std::remove(cell.begin(), cell.end(), '$'), cell.end());
+    char* end;
+    values[i] = std::strtod(cell.c_str(), &end);
+    if (end == cell.c_str()) return false;
+  }
+
+  full = encoder.Add(values[0], values[1], std::llround(values[2]), values[3],
+                     values[4], values[5], row_index);
+  return true;
+}
+
+// Parse an order book row into an update message, leaving its sequence to be
+// set by the caller. Returns false if the row is malformed.
+bool ParseBookRow(const CsvStreamReader::Chunk& chunk, std::size_t row,
+                  const column_map_t& columns, double tick_size,
+                  message::BookUpdateMessage& update) {
+  auto cell = [&](std::size_t i) {
+    return std::string(chunk.Cell(row, columns[i]));
+  };
+
+  const std::string action = cell(2);
+  const std::string side = cell(3);
+  std::string price = cell(4);
+  price.erase(std::remove(price.begin(), price.end(), '$'), price.end());
+
+  update = message::BookUpdateMessage{};
+  update.type = static_cast<std::uint8_t>(message::MessageType::kBookUpdate);
+  switch (action.empty() ? '\0' : action[0]) {
+    case 'A':
+      update.action = static_cast<std::uint8_t>(message::BookAction::kAdd);
+      break;
+    case 'M':
+      update.action = static_cast<std::uint8_t>(message::BookAction::kModify);
+      break;
+    case 'D':
+      update.action = static_cast<std::uint8_t>(message::BookAction::kDelete);
+      break;
+    default:
+      return false;
+  }
+  switch (side.empty() ? '\0' : side[0]) {
+    case 'B':
+      update.side = static_cast<std::uint8_t>(message::Side::kBid);
+      break;
+    case 'A':
+    case 'S':
+      update.side = static_cast<std::uint8_t>(message::Side::kAsk);
+      break;
+    default:
+      return false;
+  }
+
+  update.timestamp_ns = std::strtoll(cell(0).c_str(), nullptr, 10);
+  update.symbol_id =
+      static_cast<std::uint32_t>(std::strtoul(cell(1).c_str(), nullptr, 10));
+  update.price_ticks = std::llround(std::strtod(price.c_str(), nullptr) /
+                                    tick_size);
+  update.quantity = std::strtoll(cell(5).c_str(), nullptr, 10);
+  return true;
+}
+
+// Encode the book of a symbol as a snapshot message filling at most
+// out.size() bytes, keeping the best levels of each side when the book does
+// not fit. Returns the encoded length.
+std::size_t EncodeBookSnapshot(const BookFeed& feed, std::uint32_t symbol_id,
+                               std::int64_t timestamp_ns,
+                               std::vector<std::uint8_t>& out) {
+  const std::size_t max_levels =
+      (out.size() - sizeof(message::BookSnapshotHeader)) /
+      sizeof(message::BookLevel) / 2;
+
+  std::vector<message::BookLevel> bids, asks;
+  feed.book.Depth(message::Side::kBid, max_levels, bids);
+  feed.book.Depth(message::Side::kAsk, max_levels, asks);
+
+  message::BookSnapshotHeader header{};
+  header.type = static_cast<std::uint8_t>(message::MessageType::kBookSnapshot);
+  header.symbol_id = symbol_id;
+  header.timestamp_ns = timestamp_ns;
+  header.bid_count = static_cast<std::uint32_t>(bids.size());
+  header.ask_count = static_cast<std::uint32_t>(asks.size());
+  header.sequence = feed.sequence;
+  message::WriteMessage(out.data(), header);
+
+  std::uint8_t* dst = out.data() + sizeof(header);
+  for (const auto* levels : {&bids, &asks}) {
+    for (const message::BookLevel& level : *levels) {
+      message::WriteMessage(dst, level);
+      dst += sizeof(level);
+    }
+  }
+  return message::SnapshotLength(header.bid_count, header.ask_count);
+}
+
+void ReportOfferResult(std::int64_t result, std::size_t length) {
+  if (result < 0) {
+    if (BACK_PRESSURED == result) {
+      stats::Increment(stats::kOfferBackPressured);
+      std::cout << "Offer failed due to back pressure" << std::endl;
+    } else if (NOT_CONNECTED == result) {
+      stats::Increment(stats::kOfferNotConnected);
+      std::cout << "Offer failed because publisher is not connected to a "
+                   "subscriber"
+                << std::endl;
+    } else if (ADMIN_ACTION == result) {
+      stats::Increment(stats::kOfferAdminAction);
+      std::cout << "Offer failed because of an administration action in "
+                   "the system"
+                << std::endl;
+    } else if (PUBLICATION_CLOSED == result) {
+      stats::Increment(stats::kOfferClosed);
+      std::cout << "Offer failed because publication is closed" << std::endl;
+    } else {
+      stats::Increment(stats::kOfferUnknown);
+      std::cout << "Offer failed due to unknown reason " << result
+                << std::endl;
+    }
+  } else {
+    stats::Increment(stats::kMessagesSent);
+    stats::Add(stats::kBytesSent, length);
+  }
+}
+
+// Offer a message. Deltas are retried on back pressure rather than dropped,
+// since every message after a lost one would be useless to the subscriber.
+void OfferMessage(Publication& publication, concurrent::AtomicBuffer& buffer,
+                  std::size_t length, bool retry) {
+  std::int64_t result = publication.offer(buffer, 0, length);
+  while (retry && running &&
+         (BACK_PRESSURED == result || ADMIN_ACTION == result)) {
+    stats::Increment(BACK_PRESSURED == result ? stats::kOfferBackPressured
+                                              : stats::kOfferAdminAction);
+    std::this_thread::yield();
+    result = publication.offer(buffer, 0, length);
+  }
+
+  ReportOfferResult(result, length);
+}
+
+// Bytes in the term window not yet drained by the sender, assuming the
+// default window of half a term
+void UpdateRingOccupancy(Publication& publication) {
+  const std::int64_t window = publication.termBufferLength() / 2;
+  const std::int64_t remaining =
+      publication.publicationLimit() - publication.position();
+  const std::int64_t occupancy = std::max<std::int64_t>(0, window - remaining);
+  stats::Set(stats::kRingOccupancy, static_cast<std::uint64_t>(occupancy));
+}
+
 int main(int argc, char** argv) {
   CommandOptionParser cp;
-  CsvReader csv_reader;
-  CsvReader::CsvData data;
+  ReadAheadReader read_ahead(READ_AHEAD_CHUNK_ROWS, READ_AHEAD_CHUNKS);
+  column_map_t columns;
   aeron::Context context;
-  std::string row_data;
 
   cp.addOption(CommandOption(opt_help, 0, 0, "Displays help information."));
   cp.addOption(
@@ -76,6 +324,22 @@ int main(int argc, char** argv) {
   cp.addOption(
       CommandOption(opt_linger, 1, 1, "Linger timeout in milliseconds."));
   cp.addOption(CommandOption(opt_file, 1, 1, "CSV file to read data from."));
+  cp.addOption(
+      CommandOption(opt_counters, 1, 1, "Counters file for monitoring."));
+  cp.addOption(CommandOption(opt_offset, 1, 1,
+                             "Number of data rows to skip before publishing."));
+  cp.addOption(CommandOption(opt_tick_size, 1, 1,
+                             "Price increment of order book files."));
+  cp.addOption(CommandOption(opt_compress, 0, 0,
+                             "Send bars as compressed batches."));
+  cp.addOption(
+      CommandOption(opt_batch_size, 1, 1, "Bars per compressed batch."));
+  cp.addOption(CommandOption(opt_price_decimals, 1, 1,
+                             "Price decimals kept by compressed batches."));
+  cp.addOption(CommandOption(opt_keyframe_interval, 1, 1,
+                             "Compressed batches between keyframes."));
+  cp.addOption(CommandOption(opt_snapshot_interval, 1, 1,
+                             "Book updates of a symbol between snapshots."));
 
   try {
     Settings settings = ParseCmdLine(cp, argc, argv);
@@ -84,6 +348,10 @@ int main(int argc, char** argv) {
       context.aeronDir(settings.dir_prefix);
     }
 
+    stats::OpenCounters(settings.counters_path);
+    BTX_TRACE_START("publisher.trace.json");
+    BTX_TRACE_THREAD_NAME("publisher");
+
     if (settings.file_path.empty()) {
       std::ostringstream ErrorMsg;
       ErrorMsg << "\n\nUsage: " + std::string(argv[0]) + " -f <filename>\n\n"
@@ -91,10 +359,26 @@ int main(int argc, char** argv) {
                << "  -f, <filename>    CSV data file to publish\n"
                << "  -h,               Display help message";
       throw std::runtime_error(ErrorMsg.str());
-    } else {
-      data = csv_reader.ReadCSV(std::filesystem::path(settings.file_path));
+    } else if (!read_ahead.Open(
+                   std::filesystem::path(settings.file_path).string())) {
+      throw std::runtime_error("Failed to open " + settings.file_path);
+    }
+
+    // Files with an Action column hold order book updates, others bars
+    const bool book_input = read_ahead.Reader().ColumnIndex("Action") >= 0;
+    const auto& expected_columns = book_input ? BOOK_COLUMNS : BAR_COLUMNS;
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+      columns[i] = read_ahead.Reader().ColumnIndex(expected_columns[i]);
+      if (columns[i] < 0) {
+        throw std::runtime_error(std::string("Missing column ") +
+                                 expected_columns[i] + " in " +
+                                 settings.file_path);
+      }
     }
 
+    // Parse ahead while the publication is being set up
+    read_ahead.Start();
+
     std::cout << "Publishing to channel " << settings.channel
               << " on Stream ID " << settings.stream_id << std::endl;
 
@@ -130,12 +414,26 @@ int main(int argc, char** argv) {
     AERON_DECL_ALIGNED(buffer_t buffer, 16);
     concurrent::AtomicBuffer src_buffer(&buffer[0], buffer.size());
 
-    const auto& date = data.columns["Date"];
-    const auto& close = data.columns["Close/Last"];
-    const auto& volume = data.columns["Volume"];
-    const auto& open = data.columns["Open"];
-    const auto& high = data.columns["High"];
-    const auto& low = data.columns["Low"];
+    // Compressed batches of bars are built in a buffer of their own
+    const bool compress = settings.compress && !book_input;
+    message::BarBatchEncoder encoder(
+        0, static_cast<std::size_t>(settings.batch_size),
+        settings.price_decimals,
+        static_cast<std::size_t>(settings.keyframe_interval));
+    std::vector<std::uint8_t> batch(encoder.MaxLength());
+    concurrent::AtomicBuffer batch_buffer(batch.data(), batch.size());
+    if (compress && batch.size() >
+                        static_cast<std::size_t>(
+                            publication->maxMessageLength())) {
+      throw std::runtime_error("Batch size too large for the publication");
+    }
+
+    // Snapshots let late joiners of a book feed get in sync. Each symbol's
+    // updates start with one, so a book is never shown from partial state.
+    std::unordered_map<std::uint32_t, BookFeed> feeds;
+    std::vector<std::uint8_t> snapshot(
+        static_cast<std::size_t>(publication->maxMessageLength()));
+    concurrent::AtomicBuffer snapshot_buffer(snapshot.data(), snapshot.size());
 
     // Wait for a subscriber to connect before sending data
     while (!publication->isConnected() && running) {
@@ -143,50 +441,96 @@ int main(int argc, char** argv) {
           std::chrono::milliseconds(configuration::DEFAULT_POLL_TIMEOUT_MS));
     }
 
-    // Loop through data and publish each row
-    for (size_t i = 0; i < data.rows.size() && running; ++i) {
-      row_data = date[i] + "," + close[i] + "," + volume[i] + "," + open[i] +
-                 "," + high[i] + "," + low[i];
-
-      // Ensure the buffer can hold the entire row
-      if (row_data.size() > buffer.size()) {
-        std::cerr << "Warning: Row data size (" << row_data.size()
-                  << ") exceeds buffer size (" << buffer.size()
-                  << "). Truncating." << std::endl;
-        row_data = row_data.substr(0, buffer.size());
-      }
+    // Loop through the parsed chunks and publish each row
+    std::size_t row_index = 0;
+    CsvStreamReader::Chunk* chunk = nullptr;
+    while (running && (chunk = read_ahead.Acquire()) != nullptr) {
+      for (std::size_t row = 0; row < chunk->rows && running;
+           ++row, ++row_index) {
+        if (row_index < static_cast<std::size_t>(settings.row_offset)) {
+          continue;
+        }
 
-      // Copy data to the buffer
-      std::memcpy(buffer.data(), row_data.data(), row_data.size());
-      src_buffer.putBytes(0, buffer.data(), row_data.size());
-
-      const std::int64_t result =
-          publication->offer(src_buffer, 0, row_data.size());
-
-      if (result < 0) {
-        if (BACK_PRESSURED == result) {
-          std::cout << "Offer failed due to back pressure" << std::endl;
-        } else if (NOT_CONNECTED == result) {
-          std::cout << "Offer failed because publisher is not connected to a "
-                       "subscriber"
-                    << std::endl;
-        } else if (ADMIN_ACTION == result) {
-          std::cout << "Offer failed because of an administration action in "
-                       "the system"
-                    << std::endl;
-        } else if (PUBLICATION_CLOSED == result) {
-          std::cout << "Offer failed because publication is closed"
-                    << std::endl;
+        if (compress) {
+          BTX_TRACE_SCOPE("Publish");
+          bool full = false;
+          if (!AddBarRow(*chunk, row, row_index, columns, encoder, full)) {
+            std::cerr << "Warning: Skipping malformed bar row " << row_index
+                      << std::endl;
+            continue;
+          }
+          if (full) {
+            const std::size_t bar_count = encoder.Count();
+            const std::size_t length = encoder.Finish(batch.data());
+            OfferMessage(*publication, batch_buffer, length, true);
+            UpdateRingOccupancy(*publication);
+
+            // Paced once per batch for the bars it holds, so the feed runs
+            // at the same rate as uncompressed bars
+            std::this_thread::sleep_for(BAR_INTERVAL * bar_count);
+          }
         } else {
-          std::cout << "Offer failed due to unknown reason " << result
-                    << std::endl;
+          BTX_TRACE_SCOPE("Publish");
+          std::size_t length;
+          if (book_input) {
+            message::BookUpdateMessage update;
+            if (!ParseBookRow(*chunk, row, columns, settings.tick_size,
+                              update)) {
+              std::cerr << "Warning: Skipping malformed book row "
+                        << row_index << std::endl;
+              continue;
+            }
+
+            BookFeed& feed = feeds[update.symbol_id];
+            if (feed.sequence % settings.snapshot_interval == 0) {
+              const std::size_t snapshot_length = EncodeBookSnapshot(
+                  feed, update.symbol_id, update.timestamp_ns, snapshot);
+              OfferMessage(*publication, snapshot_buffer, snapshot_length,
+                           true);
+            }
+
+            update.sequence = feed.sequence++;
+            feed.book.Apply(static_cast<message::BookAction>(update.action),
+                            static_cast<message::Side>(update.side),
+                            update.price_ticks, update.quantity);
+            message::WriteMessage(buffer.data(), update);
+            length = sizeof(update);
+          } else {
+            std::size_t row_size;
+            length =
+                EncodeRow(*chunk, row, row_index, columns, buffer, row_size);
+
+            // Warn if the buffer could not hold the entire row
+            if (row_size > buffer.size()) {
+              std::cerr << "Warning: Row data size (" << row_size
+                        << ") exceeds buffer size (" << buffer.size()
+                        << "). Truncating." << std::endl;
+            }
+          }
+
+          src_buffer.putBytes(0, buffer.data(), length);
+          OfferMessage(*publication, src_buffer, length, book_input);
+          UpdateRingOccupancy(*publication);
+        }
+
+        // Bars are paced to simulate a live feed, book updates are replayed
+        // as fast as the subscriber keeps up
+        if (!book_input && !compress) {
+          std::this_thread::sleep_for(BAR_INTERVAL);
         }
       }
+      read_ahead.Release(chunk);
+    }
+    read_ahead.Stop();
 
-      std::this_thread::sleep_for(std::chrono::milliseconds(15));
+    // Send the bars of the last, partial batch
+    if (compress && running && encoder.Count() > 0) {
+      const std::size_t length = encoder.Finish(batch.data());
+      OfferMessage(*publication, batch_buffer, length, true);
     }
 
     std::cout << "Done sending." << std::endl;
+    BTX_TRACE_STOP();
 
     if (settings.linger_timeout_ms > 0) {
       std::cout << "Lingering for " << settings.linger_timeout_ms
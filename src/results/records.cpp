@@ -0,0 +1,97 @@
+#include "BackTestX/results/records.hpp"
+
+#include <cstring>
+
+namespace backtestx {
+namespace results {
+
+namespace {
+
+const std::vector<ColumnInfo> FILL_COLUMNS = {
+    {"timestamp_ns", offsetof(Fill, timestamp_ns), ColumnType::kInt64},
+    {"order_id", offsetof(Fill, order_id), ColumnType::kUInt64},
+    {"run_id", offsetof(Fill, run_id), ColumnType::kUInt32},
+    {"symbol_id", offsetof(Fill, symbol_id), ColumnType::kUInt32},
+    {"price", offsetof(Fill, price), ColumnType::kDouble},
+    {"quantity", offsetof(Fill, quantity), ColumnType::kDouble},
+    {"fee", offsetof(Fill, fee), ColumnType::kDouble},
+};
+
+const std::vector<ColumnInfo> ORDER_EVENT_COLUMNS = {
+    {"timestamp_ns", offsetof(OrderEvent, timestamp_ns), ColumnType::kInt64},
+    {"order_id", offsetof(OrderEvent, order_id), ColumnType::kUInt64},
+    {"run_id", offsetof(OrderEvent, run_id), ColumnType::kUInt32},
+    {"symbol_id", offsetof(OrderEvent, symbol_id), ColumnType::kUInt32},
+    {"price", offsetof(OrderEvent, price), ColumnType::kDouble},
+    {"quantity", offsetof(OrderEvent, quantity), ColumnType::kDouble},
+    {"event", offsetof(OrderEvent, event), ColumnType::kUInt8},
+};
+
+const std::vector<ColumnInfo> EQUITY_POINT_COLUMNS = {
+    {"timestamp_ns", offsetof(EquityPoint, timestamp_ns), ColumnType::kInt64},
+    {"run_id", offsetof(EquityPoint, run_id), ColumnType::kUInt32},
+    {"symbol_id", offsetof(EquityPoint, symbol_id), ColumnType::kUInt32},
+    {"equity", offsetof(EquityPoint, equity), ColumnType::kDouble},
+    {"position", offsetof(EquityPoint, position), ColumnType::kDouble},
+    {"price", offsetof(EquityPoint, price), ColumnType::kDouble},
+};
+
+const char* const RECORD_TYPE_NAMES[RECORD_TYPE_COUNT] = {"fills", "orders",
+                                                          "equity"};
+
+}  // namespace
+
+std::size_t ColumnWidth(ColumnType type) {
+  switch (type) {
+    case ColumnType::kInt64:
+    case ColumnType::kUInt64:
+    case ColumnType::kDouble:
+      return 8;
+    case ColumnType::kUInt32:
+      return 4;
+    case ColumnType::kUInt8:
+      return 1;
+  }
+  return 0;
+}
+
+const std::vector<ColumnInfo>& ColumnsOf(RecordType type) {
+  switch (type) {
+    case RecordType::kFill:
+      return FILL_COLUMNS;
+    case RecordType::kOrderEvent:
+      return ORDER_EVENT_COLUMNS;
+    case RecordType::kEquityPoint:
+      break;
+  }
+  return EQUITY_POINT_COLUMNS;
+}
+
+std::size_t RecordSize(RecordType type) {
+  switch (type) {
+    case RecordType::kFill:
+      return sizeof(Fill);
+    case RecordType::kOrderEvent:
+      return sizeof(OrderEvent);
+    case RecordType::kEquityPoint:
+      break;
+  }
+  return sizeof(EquityPoint);
+}
+
+const char* RecordTypeName(RecordType type) {
+  return RECORD_TYPE_NAMES[static_cast<std::size_t>(type)];
+}
+
+bool ParseRecordType(const char* name, RecordType& type) {
+  for (std::size_t i = 0; i < RECORD_TYPE_COUNT; ++i) {
+    if (std::strcmp(name, RECORD_TYPE_NAMES[i]) == 0) {
+      type = static_cast<RecordType>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace results
+}  // namespace backtestx
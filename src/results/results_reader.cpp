@@ -0,0 +1,121 @@
+#include "BackTestX/results/results_reader.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+namespace backtestx {
+namespace results {
+
+namespace {
+
+template <typename T>
+T Load(const std::uint8_t* column, std::size_t row) {
+  T value;
+  std::memcpy(&value, column + row * sizeof(T), sizeof(T));
+  return value;
+}
+
+void WriteCell(std::ostream& out, ColumnType type,
+               const std::uint8_t* column, std::size_t row) {
+  switch (type) {
+    case ColumnType::kInt64:
+      out << Load<std::int64_t>(column, row);
+      break;
+    case ColumnType::kUInt64:
+      out << Load<std::uint64_t>(column, row);
+      break;
+    case ColumnType::kUInt32:
+      out << Load<std::uint32_t>(column, row);
+      break;
+    case ColumnType::kUInt8:
+      out << static_cast<unsigned>(column[row]);
+      break;
+    case ColumnType::kDouble:
+      out << Load<double>(column, row);
+      break;
+  }
+}
+
+}  // namespace
+
+ResultsReader::ResultsReader() : header_{} {}
+
+bool ResultsReader::Open(const std::string& path) {
+  file_.open(path, std::ios::binary);
+  if (!file_.is_open()) {
+    std::cerr << "Failed to open results file: " << path << std::endl;
+    return false;
+  }
+
+  if (!file_.read(reinterpret_cast<char*>(&header_), sizeof(header_)) ||
+      header_.magic != RESULTS_MAGIC || header_.version != RESULTS_VERSION) {
+    std::cerr << "Not a results file: " << path << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool ResultsReader::Next(ResultsBlock& block) {
+  if (!file_.read(reinterpret_cast<char*>(&block.header),
+                  sizeof(block.header))) {
+    return false;
+  }
+  if (block.header.record_type >= RECORD_TYPE_COUNT) {
+    std::cerr << "Unknown record type " << block.header.record_type
+              << " in results file" << std::endl;
+    return false;
+  }
+
+  const std::vector<ColumnInfo>& columns = ColumnsOf(block.Type());
+  std::size_t length = 0;
+  block.columns.clear();
+  for (const ColumnInfo& column : columns) {
+    block.columns.push_back(nullptr);
+    length += ColumnWidth(column.type) * block.header.record_count;
+  }
+
+  block.data.resize(length);
+  if (!file_.read(reinterpret_cast<char*>(block.data.data()),
+                  static_cast<std::streamsize>(length))) {
+    std::cerr << "Truncated block in results file" << std::endl;
+    return false;
+  }
+
+  const std::uint8_t* column = block.data.data();
+  for (std::size_t c = 0; c < columns.size(); ++c) {
+    block.columns[c] = column;
+    column += ColumnWidth(columns[c].type) * block.header.record_count;
+  }
+  return true;
+}
+
+std::uint64_t ExportCsv(ResultsReader& reader, RecordType type,
+                        std::ostream& out) {
+  const std::vector<ColumnInfo>& columns = ColumnsOf(type);
+  for (std::size_t c = 0; c < columns.size(); ++c) {
+    out << (c == 0 ? "" : ",") << columns[c].name;
+  }
+  out << '\n';
+
+  // Print doubles with enough digits to read back the same value
+  out.precision(std::numeric_limits<double>::max_digits10);
+
+  std::uint64_t records = 0;
+  ResultsBlock block;
+  while (reader.Next(block)) {
+    if (block.Type() != type) continue;
+    for (std::size_t row = 0; row < block.header.record_count; ++row) {
+      for (std::size_t c = 0; c < columns.size(); ++c) {
+        if (c > 0) out << ',';
+        WriteCell(out, columns[c].type, block.columns[c], row);
+      }
+      out << '\n';
+    }
+    records += block.header.record_count;
+  }
+  return records;
+}
+
+}  // namespace results
+}  // namespace backtestx
@@ -0,0 +1,214 @@
+#include "BackTestX/results/results_writer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "BackTestX/stats/counters.hpp"
+#include "BackTestX/trace/trace.hpp"
+
+namespace backtestx {
+namespace results {
+
+namespace {
+
+// Copy one field of count records into a contiguous column
+template <std::size_t Width>
+std::uint8_t* GatherColumn(const std::uint8_t* src, std::size_t stride,
+                           std::size_t count, std::uint8_t* dst) {
+  for (std::size_t i = 0; i < count; ++i) {
+    std::memcpy(dst, src, Width);
+    src += stride;
+    dst += Width;
+  }
+  return dst;
+}
+
+}  // namespace
+
+ResultsWriter::ResultsWriter(std::size_t records_per_buffer)
+    : records_per_buffer_(std::max<std::size_t>(1, records_per_buffer)),
+      next_sink_id_(0),
+      stop_requested_(false),
+      failed_(false) {}
+
+ResultsWriter::~ResultsWriter() { Close(); }
+
+bool ResultsWriter::Open(const std::string& path) {
+  file_.open(path, std::ios::binary | std::ios::trunc);
+  if (!file_.is_open()) {
+    std::cerr << "Failed to open results file: " << path << std::endl;
+    return false;
+  }
+
+  ResultsFileHeader header{};
+  header.magic = RESULTS_MAGIC;
+  header.version = RESULTS_VERSION;
+  header.created_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+  file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  stop_requested_ = false;
+  failed_ = false;
+  thread_ = std::thread(&ResultsWriter::WriterThread, this);
+  return true;
+}
+
+std::unique_ptr<ResultsSink> ResultsWriter::CreateSink() {
+  std::uint32_t id;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    id = next_sink_id_++;
+  }
+
+  // Every sink brings a spare buffer per record type, so that one buffer can
+  // be filled while the other is being written
+  std::unique_ptr<ResultsSink> sink(new ResultsSink(*this, id));
+  for (std::size_t t = 0; t < RECORD_TYPE_COUNT; ++t) {
+    std::unique_ptr<Buffer> spare = NewBuffer(static_cast<RecordType>(t));
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_[t].push_back(std::move(spare));
+  }
+  return sink;
+}
+
+void ResultsWriter::Close() {
+  if (!thread_.joinable()) return;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_requested_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+  file_.close();
+}
+
+std::unique_ptr<ResultsWriter::Buffer> ResultsWriter::NewBuffer(
+    RecordType type) {
+  std::unique_ptr<Buffer> buffer = std::make_unique<Buffer>();
+  buffer->type = type;
+  buffer->sink_id = 0;
+  buffer->sequence = 0;
+  buffer->count = 0;
+  buffer->bytes.resize(records_per_buffer_ * RecordSize(type));
+  return buffer;
+}
+
+std::unique_ptr<ResultsWriter::Buffer> ResultsWriter::Exchange(
+    std::unique_ptr<Buffer> full) {
+  const std::size_t t = static_cast<std::size_t>(full->type);
+  std::unique_ptr<Buffer> empty;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(std::move(full));
+    if (!free_[t].empty()) {
+      empty = std::move(free_[t].back());
+      free_[t].pop_back();
+    }
+  }
+  cv_.notify_one();
+
+  // The writer is behind, grow the pool rather than wait for it
+  if (!empty) empty = NewBuffer(static_cast<RecordType>(t));
+  return empty;
+}
+
+void ResultsWriter::WriteBlock(const Buffer& buffer) {
+  BTX_TRACE_SCOPE("WriteResults");
+  if (buffer.count == 0 || failed_) return;
+
+  const std::vector<ColumnInfo>& columns = ColumnsOf(buffer.type);
+  const std::size_t record_size = RecordSize(buffer.type);
+
+  std::size_t length = 0;
+  for (const ColumnInfo& column : columns) {
+    length += ColumnWidth(column.type) * buffer.count;
+  }
+  columns_.resize(length);
+
+  std::uint8_t* dst = columns_.data();
+  for (const ColumnInfo& column : columns) {
+    const std::uint8_t* src = buffer.bytes.data() + column.offset;
+    switch (ColumnWidth(column.type)) {
+      case 8:
+        dst = GatherColumn<8>(src, record_size, buffer.count, dst);
+        break;
+      case 4:
+        dst = GatherColumn<4>(src, record_size, buffer.count, dst);
+        break;
+      default:
+        dst = GatherColumn<1>(src, record_size, buffer.count, dst);
+        break;
+    }
+  }
+
+  BlockHeader header{};
+  header.record_type = static_cast<std::uint32_t>(buffer.type);
+  header.record_count = static_cast<std::uint32_t>(buffer.count);
+  header.sink_id = buffer.sink_id;
+  header.sequence = buffer.sequence;
+  file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file_.write(reinterpret_cast<const char*>(columns_.data()),
+              static_cast<std::streamsize>(length));
+
+  if (!file_) {
+    std::cerr << "Failed to write results file, dropping further results"
+              << std::endl;
+    failed_ = true;
+    return;
+  }
+  stats::Add(stats::kResultsBytesWritten, sizeof(header) + length);
+}
+
+void ResultsWriter::WriterThread() {
+  BTX_TRACE_THREAD_NAME("results writer");
+  std::deque<std::unique_ptr<Buffer>> batch;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return !queue_.empty() || stop_requested_; });
+      if (queue_.empty()) break;
+      batch.swap(queue_);
+    }
+
+    for (const std::unique_ptr<Buffer>& buffer : batch) WriteBlock(*buffer);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (std::unique_ptr<Buffer>& buffer : batch) {
+      buffer->count = 0;
+      free_[static_cast<std::size_t>(buffer->type)].push_back(
+          std::move(buffer));
+    }
+    batch.clear();
+  }
+  file_.flush();
+}
+
+ResultsSink::ResultsSink(ResultsWriter& writer, std::uint32_t id)
+    : writer_(writer), id_(id) {
+  for (std::size_t t = 0; t < RECORD_TYPE_COUNT; ++t) {
+    sequence_[t] = 0;
+    current_[t] = writer_.NewBuffer(static_cast<RecordType>(t));
+  }
+}
+
+ResultsSink::~ResultsSink() { Flush(); }
+
+void ResultsSink::Flush() {
+  for (std::size_t t = 0; t < RECORD_TYPE_COUNT; ++t) {
+    if (current_[t]->count > 0) Submit(static_cast<RecordType>(t));
+  }
+}
+
+void ResultsSink::Submit(RecordType type) {
+  std::unique_ptr<ResultsWriter::Buffer>& buffer =
+      current_[static_cast<std::size_t>(type)];
+  buffer->sink_id = id_;
+  buffer->sequence = sequence_[static_cast<std::size_t>(type)]++;
+  buffer = writer_.Exchange(std::move(buffer));
+}
+
+}  // namespace results
+}  // namespace backtestx
@@ -0,0 +1,283 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "util/CommandOptionParser.h"
+
+#include "BackTestX/csv_reader.hpp"
+#include "BackTestX/robustness/runner.hpp"
+
+using namespace backtestx;
+using namespace aeron::util;
+
+static const char opt_help = 'h';
+static const char opt_file = 'f';
+static const char opt_paths = 'n';
+static const char opt_block = 'b';
+static const char opt_threads = 't';
+static const char opt_seed = 's';
+static const char opt_in_sample = 'w';
+static const char opt_out_of_sample = 'o';
+
+static const double TRADING_DAYS = 252.0;
+
+struct Settings {
+  std::string file_path;
+  int paths = 10000;
+  int mean_block_length = 5;
+  int threads = static_cast<int>(robustness::RunnerOptions().threads);
+  int seed = 1;
+  int in_sample = 500;
+  int out_of_sample = 100;
+};
+
+// Parameters of the sample moving average crossover strategy
+struct Crossover {
+  std::size_t fast;
+  std::size_t slow;
+};
+
+Settings ParseCmdLine(CommandOptionParser& cp, int argc, char** argv) {
+  cp.parse(argc, argv);
+  if (cp.getOption(opt_help).isPresent()) {
+    cp.displayOptionsHelp(std::cout);
+    exit(EXIT_SUCCESS);
+  }
+
+  Settings s;
+
+  s.file_path = cp.getOption(opt_file).getParam(0, s.file_path);
+  s.paths = cp.getOption(opt_paths).getParamAsInt(0, 1, INT32_MAX, s.paths);
+  s.mean_block_length = cp.getOption(opt_block).getParamAsInt(
+      0, 1, INT32_MAX, s.mean_block_length);
+  s.threads = cp.getOption(opt_threads).getParamAsInt(0, 1, 1024, s.threads);
+  s.seed = cp.getOption(opt_seed).getParamAsInt(0, 0, INT32_MAX, s.seed);
+  s.in_sample =
+      cp.getOption(opt_in_sample).getParamAsInt(0, 2, INT32_MAX, s.in_sample);
+  s.out_of_sample = cp.getOption(opt_out_of_sample)
+                        .getParamAsInt(0, 2, INT32_MAX, s.out_of_sample);
+
+  return s;
+}
+
+// Annualised Sharpe ratio of daily log returns
+double Sharpe(const double* returns, std::size_t n) {
+  robustness::RunningStats stats;
+  for (std::size_t i = 0; i < n; ++i) stats.Add(returns[i]);
+  const double sd = stats.StdDev();
+  return sd > 0 ? stats.Mean() / sd * std::sqrt(TRADING_DAYS) : 0.0;
+}
+
+// Long/flat position of the crossover, fed the closes from start on one at a
+// time. The position stays flat until the slow average is warmed up.
+class CrossoverSignal {
+ public:
+  CrossoverSignal(const std::vector<double>& closes, std::size_t start,
+                  const Crossover& params)
+      : closes_(closes),
+        start_(start),
+        params_(params),
+        fast_sum_(0),
+        slow_sum_(0),
+        long_(false) {}
+
+  // Position held after the close of bar i
+  bool Update(std::size_t i) {
+    fast_sum_ += closes_[i];
+    slow_sum_ += closes_[i];
+    if (i >= start_ + params_.fast) fast_sum_ -= closes_[i - params_.fast];
+    if (i >= start_ + params_.slow) slow_sum_ -= closes_[i - params_.slow];
+    if (i + 1 >= start_ + params_.slow) {
+      long_ = fast_sum_ / params_.fast > slow_sum_ / params_.slow;
+    }
+    return long_;
+  }
+
+ private:
+  const std::vector<double>& closes_;
+  std::size_t start_;
+  Crossover params_;
+  double fast_sum_;
+  double slow_sum_;
+  bool long_;
+};
+
+// Sharpe ratio of a long/flat moving average crossover over [begin, end),
+// with the averages warmed up from warmup_begin
+double CrossoverSharpe(const BarColumns& bars, std::size_t warmup_begin,
+                       std::size_t begin, std::size_t end,
+                       const Crossover& params) {
+  const std::vector<double>& closes = bars.closes;
+  std::vector<double> returns;
+  returns.reserve(end - begin);
+
+  CrossoverSignal signal(closes, warmup_begin, params);
+  bool long_position = false;
+  for (std::size_t i = warmup_begin; i < end; ++i) {
+    if (i > begin) {
+      returns.push_back(long_position ? std::log(closes[i] / closes[i - 1])
+                                      : 0.0);
+    }
+    long_position = signal.Update(i);
+  }
+  return Sharpe(returns.data(), returns.size());
+}
+
+// Log return of every round trip of the crossover over all bars. A position
+// still open at the end is closed at the last close.
+std::vector<double> CrossoverTrades(const BarColumns& bars,
+                                    const Crossover& params) {
+  const std::vector<double>& closes = bars.closes;
+  std::vector<double> trades;
+
+  CrossoverSignal signal(closes, 0, params);
+  bool long_position = false;
+  std::size_t entry = 0;
+  for (std::size_t i = 0; i < closes.size(); ++i) {
+    const bool next = signal.Update(i);
+    if (next && !long_position) {
+      entry = i;
+    } else if (!next && long_position) {
+      trades.push_back(std::log(closes[i] / closes[entry]));
+    }
+    long_position = next;
+  }
+  if (long_position) {
+    trades.push_back(std::log(closes.back() / closes[entry]));
+  }
+  return trades;
+}
+
+// Sum of log returns
+double TotalReturn(const double* returns, std::size_t n) {
+  double total = 0;
+  for (std::size_t i = 0; i < n; ++i) total += returns[i];
+  return total;
+}
+
+void PrintDistribution(const std::string& name,
+                       const robustness::Distribution& distribution) {
+  const auto& stats = distribution.stats;
+  const auto& histogram = distribution.histogram;
+  std::printf(
+      "%-28s n=%llu mean=%.3f sd=%.3f min=%.3f p5=%.3f p50=%.3f p95=%.3f "
+      "max=%.3f\n",
+      name.c_str(), static_cast<unsigned long long>(stats.Count()),
+      stats.Mean(), stats.StdDev(), stats.Min(), histogram.Quantile(0.05),
+      histogram.Quantile(0.5), histogram.Quantile(0.95), stats.Max());
+}
+
+int main(int argc, char** argv) {
+  CommandOptionParser cp;
+  CsvReader csv_reader;
+
+  cp.addOption(CommandOption(opt_help, 0, 0, "Displays help information."));
+  cp.addOption(CommandOption(opt_file, 1, 1, "CSV file to read data from."));
+  cp.addOption(CommandOption(opt_paths, 1, 1, "Number of bootstrap paths."));
+  cp.addOption(CommandOption(opt_block, 1, 1, "Mean bootstrap block length."));
+  cp.addOption(CommandOption(opt_threads, 1, 1, "Number of worker threads."));
+  cp.addOption(CommandOption(opt_seed, 1, 1, "Random seed."));
+  cp.addOption(
+      CommandOption(opt_in_sample, 1, 1, "Walk-forward in-sample bars."));
+  cp.addOption(CommandOption(opt_out_of_sample, 1, 1,
+                             "Walk-forward out-of-sample bars."));
+
+  try {
+    Settings settings = ParseCmdLine(cp, argc, argv);
+
+    if (settings.file_path.empty()) {
+      std::ostringstream ErrorMsg;
+      ErrorMsg << "\n\nUsage: " + std::string(argv[0]) + " -f <filename>\n\n"
+               << "Options:\n"
+               << "  -f, <filename>    CSV data file to analyse\n"
+               << "  -h,               Display help message";
+      throw std::runtime_error(ErrorMsg.str());
+    }
+
+    BarColumns bars = robustness::ToBarColumns(
+        csv_reader.ReadCSV(std::filesystem::path(settings.file_path)));
+    if (bars.size() < 2) {
+      throw std::runtime_error("Need at least two bars in " +
+                               settings.file_path);
+    }
+
+    robustness::RunnerOptions options;
+    options.seed = static_cast<std::uint64_t>(settings.seed);
+    options.threads = static_cast<unsigned>(settings.threads);
+    const robustness::Histogram sharpe_bins(-5.0, 5.0, 1000);
+    const robustness::Histogram return_bins(-5.0, 5.0, 1000);
+
+    std::cout << "Loaded " << bars.size() << " bars, running on "
+              << options.threads << " threads with seed " << options.seed
+              << std::endl;
+
+    // Bootstrap of buy-and-hold returns
+    const std::vector<double> returns = robustness::LogReturns(bars.closes);
+    PrintDistribution("Buy and hold Sharpe",
+                      robustness::Bootstrap(
+                          returns, settings.paths, settings.mean_block_length,
+                          options, sharpe_bins, Sharpe));
+
+    // Walk-forward optimisation of the crossover lengths. A slow average
+    // longer than the in-sample window would never take a position there.
+    std::vector<Crossover> grid;
+    for (std::size_t fast = 5; fast <= 50; fast += 5) {
+      for (std::size_t slow = fast * 2;
+           slow <= 200 && slow < static_cast<std::size_t>(settings.in_sample);
+           slow += 10) {
+        grid.push_back({fast, slow});
+      }
+    }
+    if (grid.empty()) {
+      throw std::runtime_error("In-sample window too short for the grid");
+    }
+    const auto windows = robustness::WalkForwardWindows(
+        bars.size(), settings.in_sample, settings.out_of_sample,
+        settings.out_of_sample);
+    if (windows.empty()) {
+      // Without a single window every vote would be zero and the trade
+      // bootstrap would silently use the first grid entry
+      std::cout << "Skipping walk-forward and trade bootstrap: "
+                << bars.size() << " bars do not fill one in-sample plus "
+                << "out-of-sample window of "
+                << settings.in_sample + settings.out_of_sample << " bars"
+                << std::endl;
+      return 0;
+    }
+    const auto walk_forward = robustness::WalkForward(
+        bars, windows, grid, options, sharpe_bins, CrossoverSharpe);
+    PrintDistribution("Walk-forward OOS Sharpe", walk_forward.out_of_sample);
+
+    // Bootstrap of the trades of the parameters the walk-forward chose most
+    // often. Trades are independent draws, hence a block length of 1.
+    std::vector<std::size_t> votes(grid.size(), 0);
+    for (std::size_t chosen : walk_forward.chosen) ++votes[chosen];
+    const Crossover& params =
+        grid[std::max_element(votes.begin(), votes.end()) - votes.begin()];
+    const std::vector<double> trades = CrossoverTrades(bars, params);
+    if (trades.empty()) {
+      std::cout << "Crossover made no trades" << std::endl;
+    } else {
+      char name[64];
+      std::snprintf(name, sizeof(name), "Crossover %zu/%zu trade return",
+                    params.fast, params.slow);
+      PrintDistribution(
+          name, robustness::Bootstrap(trades, settings.paths, 1.0, options,
+                                      return_bins, TotalReturn));
+    }
+  } catch (const CommandOptionException& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+    cp.displayOptionsHelp(std::cerr);
+    return -1;
+  } catch (const std::exception& e) {
+    std::cerr << "FAILED: " << e.what() << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,205 @@
+#include "BackTestX/robustness/runner.hpp"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace backtestx {
+namespace robustness {
+
+namespace {
+
+std::uint64_t SplitMix64(std::uint64_t& x) {
+  std::uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+inline std::uint64_t Rotl(std::uint64_t x, int k) {
+  return (x << k) | (x >> (64 - k));
+}
+
+// Prices may carry a leading '$'
+double ParseNumber(const std::string& cell) {
+  const char* begin = cell.c_str();
+  while (*begin == '$' || *begin == ' ') ++begin;
+  return std::strtod(begin, nullptr);
+}
+
+}  // namespace
+
+Rng::Rng(std::uint64_t seed) {
+  for (auto& word : state_) word = SplitMix64(seed);
+}
+
+Rng Rng::ForTask(std::uint64_t seed, std::uint64_t task) {
+  // Decorrelate neighbouring task indices before seeding
+  std::uint64_t mix = seed ^ (task * 0xD1B54A32D192ED03ULL);
+  return Rng(SplitMix64(mix));
+}
+
+std::uint64_t Rng::Next() {
+  const std::uint64_t result = Rotl(state_[1] * 5, 7) * 9;
+  const std::uint64_t t = state_[1] << 17;
+  state_[2] ^= state_[0];
+  state_[3] ^= state_[1];
+  state_[1] ^= state_[2];
+  state_[0] ^= state_[3];
+  state_[2] ^= t;
+  state_[3] = Rotl(state_[3], 45);
+  return result;
+}
+
+double Rng::NextDouble() { return (Next() >> 11) * 0x1.0p-53; }
+
+std::uint64_t Rng::NextBelow(std::uint64_t bound) {
+  // Lemire's multiply-shift reduction
+  return static_cast<std::uint64_t>(
+      (static_cast<unsigned __int128>(Next()) * bound) >> 64);
+}
+
+RunningStats::RunningStats()
+    : count_(0),
+      mean_(0),
+      m2_(0),
+      min_(std::numeric_limits<double>::infinity()),
+      max_(-std::numeric_limits<double>::infinity()) {}
+
+void RunningStats::Add(double x) {
+  ++count_;
+  const double delta = x - mean_;
+  mean_ += delta / count_;
+  m2_ += delta * (x - mean_);
+  min_ = std::min(min_, x);
+  max_ = std::max(max_, x);
+}
+
+void RunningStats::Merge(const RunningStats& other) {
+  if (other.count_ == 0) return;
+  if (count_ == 0) {
+    *this = other;
+    return;
+  }
+
+  const std::uint64_t count = count_ + other.count_;
+  const double delta = other.mean_ - mean_;
+  mean_ += delta * other.count_ / count;
+  m2_ += other.m2_ + delta * delta * count_ * other.count_ / count;
+  count_ = count;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+}
+
+double RunningStats::Variance() const {
+  return count_ > 1 ? m2_ / (count_ - 1) : 0.0;
+}
+
+double RunningStats::StdDev() const { return std::sqrt(Variance()); }
+
+Histogram::Histogram(double low, double high, std::size_t bins)
+    : low_(low),
+      high_(high),
+      scale_(bins / (high - low)),
+      total_(0),
+      counts_(std::max<std::size_t>(1, bins), 0) {}
+
+void Histogram::Add(double x) {
+  const double position = (x - low_) * scale_;
+  std::size_t bin = 0;
+  if (position >= counts_.size()) {
+    bin = counts_.size() - 1;
+  } else if (position > 0) {
+    bin = static_cast<std::size_t>(position);
+  }
+  ++counts_[bin];
+  ++total_;
+}
+
+void Histogram::Merge(const Histogram& other) {
+  for (std::size_t i = 0; i < counts_.size() && i < other.counts_.size(); ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  total_ += other.total_;
+}
+
+double Histogram::Quantile(double q) const {
+  if (total_ == 0) return 0.0;
+
+  const double target = q * total_;
+  double cumulative = 0;
+  for (std::size_t i = 0; i < counts_.size(); ++i) {
+    if (cumulative + counts_[i] >= target && counts_[i] > 0) {
+      // Interpolate linearly inside the bin
+      const double fraction = (target - cumulative) / counts_[i];
+      return low_ + (i + fraction) / scale_;
+    }
+    cumulative += counts_[i];
+  }
+  return high_;
+}
+
+std::vector<Window> WalkForwardWindows(std::size_t bar_count,
+                                       std::size_t in_sample,
+                                       std::size_t out_of_sample,
+                                       std::size_t step) {
+  std::vector<Window> windows;
+  if (in_sample == 0 || out_of_sample == 0 || step == 0) return windows;
+
+  for (std::size_t begin = 0; begin + in_sample + out_of_sample <= bar_count;
+       begin += step) {
+    windows.push_back({begin, begin + in_sample, begin + in_sample,
+                       begin + in_sample + out_of_sample});
+  }
+  return windows;
+}
+
+BarColumns ToBarColumns(const CsvReader::CsvData& data) {
+  const auto& date = data["Date"];
+  const auto& close = data["Close/Last"];
+  const auto& volume = data["Volume"];
+  const auto& open = data["Open"];
+  const auto& high = data["High"];
+  const auto& low = data["Low"];
+
+  BarColumns bars;
+  bars.reserve(date.size());
+  for (std::size_t i = 0; i < date.size(); ++i) {
+    bars.Append(ParseNumber(date[i]), ParseNumber(close[i]),
+                static_cast<int>(ParseNumber(volume[i])), ParseNumber(open[i]),
+                ParseNumber(high[i]), ParseNumber(low[i]));
+  }
+  return bars;
+}
+
+std::vector<double> LogReturns(const std::vector<double>& closes) {
+  std::vector<double> returns;
+  if (closes.size() < 2) return returns;
+
+  returns.reserve(closes.size() - 1);
+  for (std::size_t i = 1; i < closes.size(); ++i) {
+    returns.push_back(std::log(closes[i] / closes[i - 1]));
+  }
+  return returns;
+}
+
+void StationaryBootstrap(const std::vector<double>& source,
+                         double mean_block_length, Rng& rng,
+                         std::vector<double>& path) {
+  const std::size_t n = source.size();
+  path.resize(n);
+  if (n == 0) return;
+
+  const double restart = 1.0 / std::max(1.0, mean_block_length);
+  std::size_t position = rng.NextBelow(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    path[i] = source[position];
+    if (rng.NextDouble() < restart) {
+      position = rng.NextBelow(n);
+    } else if (++position == n) {
+      position = 0;
+    }
+  }
+}
+
+}  // namespace robustness
+}  // namespace backtestx
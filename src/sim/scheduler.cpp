@@ -0,0 +1,214 @@
+#include "BackTestX/sim/scheduler.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace backtestx {
+namespace sim {
+
+Scheduler::Scheduler(std::size_t initial_capacity)
+    : free_head_(NIL),
+      occupied_(0),
+      front_(0),
+      last_(0),
+      now_(0),
+      pending_(0),
+      cancelled_(0) {
+  nodes_.reserve(initial_capacity);
+}
+
+EventHandle Scheduler::Schedule(SimTime time, EventCallback callback,
+                                void* context, std::uint64_t data) {
+  return SchedulePeriodic(time, 0, callback, context, data);
+}
+
+EventHandle Scheduler::ScheduleAfter(SimTime delay, EventCallback callback,
+                                     void* context, std::uint64_t data) {
+  return SchedulePeriodic(now_ + delay, 0, callback, context, data);
+}
+
+EventHandle Scheduler::SchedulePeriodic(SimTime first, SimTime period,
+                                        EventCallback callback, void* context,
+                                        std::uint64_t data) {
+  if (first < now_) {
+    throw std::invalid_argument("Cannot schedule an event in the past");
+  }
+  if (callback == nullptr) {
+    throw std::invalid_argument("Event callback must not be null");
+  }
+
+  const std::uint32_t index = Allocate();
+  Node& node = nodes_[index];
+  node.time = first;
+  node.period = period;
+  node.callback = callback;
+  node.context = context;
+  node.data = data;
+  node.state = kPending;
+  ++pending_;
+  Push(first, index);
+
+  EventHandle handle;
+  handle.index = index;
+  handle.generation = node.generation;
+  return handle;
+}
+
+bool Scheduler::Cancel(EventHandle handle) {
+  if (handle.index >= nodes_.size()) return false;
+
+  Node& node = nodes_[handle.index];
+  if (node.generation != handle.generation) return false;
+
+  switch (node.state) {
+    case kPending:
+      node.state = kCancelled;
+      --pending_;
+      ++cancelled_;
+      return true;
+    case kRunning:
+      // Only a periodic event has a future to cancel once it is running
+      if (node.period == 0) return false;
+      node.state = kCancelled;
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool Scheduler::RunNext() {
+  const std::uint32_t index = PopDue(std::numeric_limits<SimTime>::max());
+  if (index == NIL) return false;
+  Run(index);
+  return true;
+}
+
+std::size_t Scheduler::RunUntil(SimTime time) {
+  if (time < now_) {
+    throw std::invalid_argument("Cannot move the simulation clock backwards");
+  }
+
+  std::size_t count = 0;
+  std::uint32_t index;
+  while ((index = PopDue(time)) != NIL) {
+    Run(index);
+    ++count;
+  }
+  now_ = time;
+  return count;
+}
+
+std::uint32_t Scheduler::Allocate() {
+  if (free_head_ != NIL) {
+    const std::uint32_t index = free_head_;
+    free_head_ = nodes_[index].next;
+    return index;
+  }
+
+  if (nodes_.size() >= NIL) {
+    throw std::runtime_error("Too many pending events");
+  }
+  Node node = {};
+  node.state = kFree;
+  nodes_.push_back(node);
+  return static_cast<std::uint32_t>(nodes_.size() - 1);
+}
+
+void Scheduler::Release(std::uint32_t index) {
+  Node& node = nodes_[index];
+  ++node.generation;
+  node.state = kFree;
+  node.next = free_head_;
+  free_head_ = index;
+}
+
+std::uint32_t Scheduler::PopDue(SimTime limit) {
+  while (true) {
+    // Bucket 0 holds the events due exactly at last_, in scheduling order
+    std::vector<Entry>& front = buckets_[0];
+    while (front_ < front.size()) {
+      const std::uint32_t index = front[front_++].index;
+      if (nodes_[index].state != kCancelled) return index;
+      --cancelled_;
+      Release(index);
+    }
+    front.clear();
+    front_ = 0;
+
+    if (occupied_ == 0) return NIL;
+    const int b = __builtin_ctzll(occupied_) + 1;
+
+    // Drop cancelled events first, so the heap is never rebased on a time
+    // at which nothing runs
+    std::vector<Entry>& bucket = buckets_[b];
+    if (cancelled_ > 0) {
+      std::size_t kept = 0;
+      for (const Entry& entry : bucket) {
+        if (nodes_[entry.index].state == kCancelled) {
+          --cancelled_;
+          Release(entry.index);
+        } else {
+          bucket[kept++] = entry;
+        }
+      }
+      bucket.resize(kept);
+      if (bucket.empty()) {
+        occupied_ &= ~(1ULL << (b - 1));
+        continue;
+      }
+    }
+
+    SimTime earliest = bucket.front().time;
+    for (const Entry& entry : bucket) {
+      earliest = std::min(earliest, entry.time);
+    }
+    if (earliest > limit) return NIL;
+
+    // Rebase the heap on the earliest time and spread the bucket over the
+    // lower buckets. Those are empty, so the relative order of equal times
+    // is preserved.
+    last_ = earliest;
+    occupied_ &= ~(1ULL << (b - 1));
+    for (const Entry& entry : bucket) Push(entry.time, entry.index);
+    bucket.clear();
+  }
+}
+
+void Scheduler::Run(std::uint32_t index) {
+  Node& node = nodes_[index];
+  node.state = kRunning;
+  now_ = node.time;
+  --pending_;
+
+  // The callback may schedule events, which can reallocate the pool
+  const EventCallback callback = node.callback;
+  void* const context = node.context;
+  const std::uint64_t data = node.data;
+  callback(context, data);
+
+  Node& ran = nodes_[index];
+  if (ran.state == kRunning && ran.period != 0) {
+    ran.time += ran.period;
+    ran.state = kPending;
+    ++pending_;
+    Push(ran.time, index);
+  } else {
+    Release(index);
+  }
+}
+
+BarClock::BarClock(Scheduler& scheduler,
+                   std::shared_ptr<strategy::BarListener> downstream)
+    : scheduler_(scheduler), downstream_(std::move(downstream)) {}
+
+void BarClock::OnBar(const BarColumns& bars, std::size_t index) {
+  // Bars with a repeated or older date leave the clock where it is
+  scheduler_.RunUntil(
+      std::max(scheduler_.Now(), FromBarDate(bars.dates[index])));
+  if (downstream_) downstream_->OnBar(bars, index);
+}
+
+}  // namespace sim
+}  // namespace backtestx
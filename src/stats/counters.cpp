@@ -0,0 +1,257 @@
+#include "BackTestX/stats/counters.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace backtestx {
+namespace stats {
+
+namespace {
+
+struct CounterInfo {
+  const char *label;
+  CounterKind kind;
+};
+
+const CounterInfo COUNTER_INFO[kCounterCount] = {
+    {"Messages sent", kTotal},
+    {"Bytes sent", kTotal},
+    {"Offer failed: back pressured", kTotal},
+    {"Offer failed: not connected", kTotal},
+    {"Offer failed: admin action", kTotal},
+    {"Offer failed: publication closed", kTotal},
+    {"Offer failed: unknown", kTotal},
+    {"Messages received", kTotal},
+    {"Bytes received", kTotal},
+    {"Parse errors", kTotal},
+    {"Ring occupancy (bytes)", kGauge},
+    {"Store size (bars)", kGauge},
+    {"GUI frame time (ns)", kGauge},
+    {"Read-ahead chunks queued", kGauge},
+    {"Book updates", kTotal},
+    {"Results bytes written", kTotal},
+    {"Bar batches dropped", kTotal},
+    {"Book updates dropped", kTotal},
+    {"Book snapshots", kTotal},
+};
+
+CounterSlot g_local_slots[kCounterCount];
+
+// File backing the process-wide counters, never destroyed
+CountersFile *g_counters_file = nullptr;
+
+void UnlinkCountersFile() { g_counters_file->Unlink(); }
+
+std::runtime_error SystemError(const std::string &what,
+                               const std::string &path) {
+  return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+std::filesystem::path CountersDirectory() {
+  std::filesystem::path dir("/dev/shm");
+  if (!std::filesystem::is_directory(dir)) {
+    dir = std::filesystem::temp_directory_path();
+  }
+  return dir;
+}
+
+// Pid recorded in an existing counters file, or 0 if there is no valid file
+std::int32_t OwnerPid(const std::string &path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return 0;
+
+  CountersHeader header;
+  const ssize_t length = ::pread(fd, &header, sizeof(header), 0);
+  ::close(fd);
+  if (length != static_cast<ssize_t>(sizeof(header)) ||
+      header.magic != COUNTERS_MAGIC) {
+    return 0;
+  }
+  return header.pid;
+}
+
+}  // namespace
+
+namespace detail {
+CounterSlot *g_slots = g_local_slots;
+}  // namespace detail
+
+CountersFile::CountersFile()
+    : address_(nullptr), length_(0), header_(nullptr), slots_(nullptr) {}
+
+CountersFile::~CountersFile() {
+  Unmap();
+  Unlink();
+}
+
+void CountersFile::Unlink() {
+  // Monitors still attached keep their mapping of the removed file
+  if (!created_path_.empty()) ::unlink(created_path_.c_str());
+  created_path_.clear();
+}
+
+std::size_t CountersFile::FileSize(std::uint32_t counter_count) {
+  return sizeof(CountersHeader) + counter_count * sizeof(CounterSlot);
+}
+
+std::uint32_t CountersFile::CounterCount() const {
+  return header_ ? header_->counter_count : 0;
+}
+
+void CountersFile::Create(const std::string &path) {
+  Unmap();
+
+  // Truncating a file that another process has mapped would crash it or
+  // reset its counters
+  const std::int32_t owner = OwnerPid(path);
+  if (owner > 0 && owner != ::getpid() && ProcessAlive(owner)) {
+    throw std::runtime_error("Counters file " + path +
+                             " is in use by process " + std::to_string(owner));
+  }
+
+  // Replace a stale file instead of truncating it, so that a monitor still
+  // attached to it is not left with a mapping past the end of the file
+  if (::unlink(path.c_str()) != 0 && errno != ENOENT) {
+    throw SystemError("Failed to remove stale counters file", path);
+  }
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0) throw SystemError("Failed to create counters file", path);
+  created_path_ = path;
+
+  const std::size_t length = FileSize(kCounterCount);
+  if (::ftruncate(fd, static_cast<off_t>(length)) != 0) {
+    ::close(fd);
+    throw SystemError("Failed to size counters file", path);
+  }
+
+  void *address =
+      ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (address == MAP_FAILED) {
+    throw SystemError("Failed to map counters file", path);
+  }
+
+  address_ = address;
+  length_ = length;
+  header_ = static_cast<CountersHeader *>(address);
+  slots_ = reinterpret_cast<CounterSlot *>(static_cast<char *>(address) +
+                                           sizeof(CountersHeader));
+
+  for (std::uint32_t i = 0; i < kCounterCount; ++i) {
+    CounterSlot &slot = slots_[i];
+    slot.value.store(0, std::memory_order_relaxed);
+    slot.kind = COUNTER_INFO[i].kind;
+    std::strncpy(slot.label, COUNTER_INFO[i].label, sizeof(slot.label) - 1);
+    slot.label[sizeof(slot.label) - 1] = '\0';
+  }
+
+  header_->version = COUNTERS_VERSION;
+  header_->counter_count = kCounterCount;
+  header_->pid = static_cast<std::int32_t>(::getpid());
+  header_->start_time_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count();
+
+  // Publish the magic last so readers never see a half initialised file
+  std::atomic_thread_fence(std::memory_order_release);
+  header_->magic = COUNTERS_MAGIC;
+}
+
+void CountersFile::Attach(const std::string &path) {
+  Unmap();
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) throw SystemError("Failed to open counters file", path);
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0 ||
+      static_cast<std::size_t>(st.st_size) < sizeof(CountersHeader)) {
+    ::close(fd);
+    throw std::runtime_error("Invalid counters file " + path);
+  }
+
+  const std::size_t length = static_cast<std::size_t>(st.st_size);
+  void *address = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (address == MAP_FAILED) {
+    throw SystemError("Failed to map counters file", path);
+  }
+
+  address_ = address;
+  length_ = length;
+  header_ = static_cast<CountersHeader *>(address);
+  slots_ = reinterpret_cast<CounterSlot *>(static_cast<char *>(address) +
+                                           sizeof(CountersHeader));
+
+  if (header_->magic != COUNTERS_MAGIC ||
+      header_->version != COUNTERS_VERSION ||
+      length < FileSize(header_->counter_count)) {
+    Unmap();
+    throw std::runtime_error("Invalid counters file " + path);
+  }
+}
+
+void CountersFile::Unmap() {
+  if (address_) ::munmap(address_, length_);
+  address_ = nullptr;
+  length_ = 0;
+  header_ = nullptr;
+  slots_ = nullptr;
+}
+
+std::string DefaultCountersPath(const std::string &name) {
+  return (CountersDirectory() / ("backtestx-" + name + "-" +
+                                 std::to_string(::getpid()) + ".stat"))
+      .string();
+}
+
+std::vector<std::string> ListCountersFiles() {
+  std::vector<std::string> paths;
+  std::error_code error;
+  for (const auto &entry :
+       std::filesystem::directory_iterator(CountersDirectory(), error)) {
+    const std::string name = entry.path().filename().string();
+    if (name.rfind("backtestx-", 0) == 0 &&
+        entry.path().extension() == ".stat") {
+      paths.push_back(entry.path().string());
+    }
+  }
+  std::sort(paths.begin(), paths.end());
+  return paths;
+}
+
+bool ProcessAlive(std::int32_t pid) {
+  return pid > 0 && (::kill(pid, 0) == 0 || errno == EPERM);
+}
+
+void OpenCounters(const std::string &path) {
+  if (!g_counters_file) {
+    g_counters_file = new CountersFile();
+    std::atexit(UnlinkCountersFile);
+  }
+
+  // Counters updated while the file is replaced go to local memory
+  detail::g_slots = g_local_slots;
+  g_counters_file->Unlink();
+  g_counters_file->Create(path);
+  detail::g_slots = g_counters_file->Slots();
+}
+
+const char *CounterLabel(CounterId id) { return COUNTER_INFO[id].label; }
+
+CounterKind CounterKindOf(CounterId id) { return COUNTER_INFO[id].kind; }
+
+}  // namespace stats
+}  // namespace backtestx
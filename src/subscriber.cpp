@@ -1,4 +1,5 @@
 #include <cstdint>
+#include <ctime>
 #include <thread>
 #include <csignal>
 
@@ -7,9 +8,18 @@
 #include "FragmentAssembler.h"
 #include "util/CommandOptionParser.h"
 
+#include "BackTestX/checkpoint/checkpointer.hpp"
 #include "BackTestX/config/aeron_config.hpp"
+#include "BackTestX/book/book_store.hpp"
 #include "BackTestX/graphical/gui.hpp"
+#include "BackTestX/message/book_message.hpp"
 #include "BackTestX/plot/data_handler.hpp"
+#include "BackTestX/results/results_writer.hpp"
+#include "BackTestX/sim/scheduler.hpp"
+#include "BackTestX/stats/counters.hpp"
+#include "BackTestX/strategy/pipeline.hpp"
+#include "BackTestX/strategy/record_results.hpp"
+#include "BackTestX/trace/trace.hpp"
 
 using namespace aeron;
 using namespace aeron::util;
@@ -23,14 +33,92 @@ static const char opt_help = 'h';
 static const char opt_prefix = 'p';
 static const char opt_channel = 'c';
 static const char opt_stream_id = 's';
+static const char opt_counters = 'm';
+static const char opt_checkpoint = 'k';
+static const char opt_checkpoint_interval = 'i';
+static const char opt_results = 'r';
+static const char opt_clock_report = 'e';
 
 static const std::chrono::duration<long, std::milli> IDLE_SLEEP_MS(1);
 static const int FRAGMENTS_LIMIT = 10;
+static const int DEFAULT_CHECKPOINT_INTERVAL_MS = 5000;
 
 struct Settings {
   std::string dir_prefix;
   std::string channel = configuration::DEFAULT_CHANNEL;
   std::int32_t stream_id = configuration::DEFAULT_STREAM_ID;
+  std::string counters_path = stats::DefaultCountersPath("subscriber");
+  std::string checkpoint_path;
+  int checkpoint_interval_ms = DEFAULT_CHECKPOINT_INTERVAL_MS;
+  std::string results_path;
+  int clock_report_seconds = 0;
+};
+
+// Sample strategy run on the live bars when results are recorded: long/flat
+// EMA crossovers over four EMA lengths, one run per length
+static const std::size_t SAMPLE_LANES = 4;
+typedef strategy::LaneState<SAMPLE_LANES> SampleState;
+typedef strategy::Pipeline<SampleState, strategy::EmaIndicator<SAMPLE_LANES>,
+                           strategy::CrossoverSignal, strategy::FixedSizing,
+                           strategy::MarkToMarket,
+                           strategy::RecordResults<SAMPLE_LANES>>
+    SamplePipeline;
+
+std::shared_ptr<strategy::BarListener> MakeSampleStrategy(
+    results::ResultsSink* sink) {
+  const std::array<double, SAMPLE_LANES> alphas = {2.0 / 11, 2.0 / 21,
+                                                   2.0 / 51, 2.0 / 101};
+  return std::make_shared<strategy::PipelineAdapter<SamplePipeline>>(
+      SamplePipeline(strategy::EmaIndicator<SAMPLE_LANES>(alphas),
+                     strategy::CrossoverSignal(),
+                     strategy::FixedSizing(1.0, true),
+                     strategy::MarkToMarket(0.0),
+                     strategy::RecordResults<SAMPLE_LANES>(sink)));
+}
+
+// Sits behind a BarClock and reports every period of simulated time how many
+// bars arrived in it. The first report is scheduled one period after the
+// first bar rather than from time zero, so the clock does not have to catch
+// up on decades of empty periods.
+class ClockReport : public strategy::BarListener {
+ public:
+  ClockReport(sim::Scheduler& scheduler, sim::SimTime period,
+              std::shared_ptr<strategy::BarListener> downstream)
+      : scheduler_(scheduler),
+        period_(period),
+        downstream_(std::move(downstream)),
+        started_(false),
+        bars_(0) {}
+
+  void OnBar(const BarColumns& bars, std::size_t index) override {
+    if (!started_) {
+      scheduler_.SchedulePeriodic(scheduler_.Now() + period_, period_,
+                                  &ClockReport::Report, this);
+      started_ = true;
+    }
+    ++bars_;
+    if (downstream_) downstream_->OnBar(bars, index);
+  }
+
+ private:
+  static void Report(void* context, std::uint64_t) {
+    auto* self = static_cast<ClockReport*>(context);
+    const std::time_t seconds = static_cast<std::time_t>(
+        self->scheduler_.Now() / sim::NANOS_PER_SECOND);
+    std::tm date{};
+    gmtime_r(&seconds, &date);
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &date);
+    std::cout << "Simulated time " << text << ": " << self->bars_
+              << " bars since the last report" << std::endl;
+    self->bars_ = 0;
+  }
+
+  sim::Scheduler& scheduler_;
+  sim::SimTime period_;
+  std::shared_ptr<strategy::BarListener> downstream_;
+  bool started_;
+  std::uint64_t bars_;
 };
 
 Settings parseCmdLine(CommandOptionParser& cp, int argc, char** argv) {
@@ -46,14 +134,46 @@ Settings parseCmdLine(CommandOptionParser& cp, int argc, char** argv) {
   s.channel = cp.getOption(opt_channel).getParam(0, s.channel);
   s.stream_id =
       cp.getOption(opt_stream_id).getParamAsInt(0, 1, INT32_MAX, s.stream_id);
+  s.counters_path = cp.getOption(opt_counters).getParam(0, s.counters_path);
+  s.checkpoint_path =
+      cp.getOption(opt_checkpoint).getParam(0, s.checkpoint_path);
+  s.checkpoint_interval_ms =
+      cp.getOption(opt_checkpoint_interval)
+          .getParamAsInt(0, 1, 60 * 60 * 1000, s.checkpoint_interval_ms);
+  s.results_path = cp.getOption(opt_results).getParam(0, s.results_path);
+  s.clock_report_seconds =
+      cp.getOption(opt_clock_report)
+          .getParamAsInt(0, 1, INT32_MAX, s.clock_report_seconds);
 
   return s;
 }
 
 fragment_handler_t DataPlottingHandler(
-    std::shared_ptr<backtestx::plot::DataHandler> data_handler) {
-  return [data_handler](const AtomicBuffer& buffer, util::index_t offset,
-                        util::index_t length, const Header& header) {
+    std::shared_ptr<backtestx::plot::DataHandler> data_handler,
+    std::shared_ptr<backtestx::book::BookStore> book_store) {
+  return [data_handler, book_store](const AtomicBuffer& buffer,
+                                    util::index_t offset, util::index_t length,
+                                    const Header&) {
+    stats::Increment(stats::kMessagesReceived);
+    stats::Add(stats::kBytesReceived, static_cast<std::uint64_t>(length));
+
+    // Binary messages carry compressed bars or order book data, text
+    // messages carry single bars
+    const std::uint8_t* bytes = buffer.buffer() + offset;
+    const std::size_t size = static_cast<std::size_t>(length);
+    const auto bar_batch =
+        static_cast<std::uint8_t>(message::MessageType::kBarBatch);
+    if (size > 0 && bytes[0] == bar_batch) {
+      data_handler->ProcessBatch(bytes, size);
+      return;
+    }
+    if (message::IsBinaryMessage(bytes, size)) {
+      if (!book_store->ProcessMessage(bytes, size)) {
+        stats::Increment(stats::kParseErrors);
+      }
+      return;
+    }
+
     std::string data(reinterpret_cast<const char*>(buffer.buffer()) + offset,
                      static_cast<std::size_t>(length));
     data_handler->ProcessData(data);
@@ -67,18 +187,87 @@ int main(int argc, char** argv) {
       CommandOption(opt_prefix, 1, 1, "Prefix directory for aeron driver."));
   cp.addOption(CommandOption(opt_channel, 1, 1, "Channel."));
   cp.addOption(CommandOption(opt_stream_id, 1, 1, "Stream ID."));
+  cp.addOption(
+      CommandOption(opt_counters, 1, 1, "Counters file for monitoring."));
+  cp.addOption(CommandOption(opt_checkpoint, 1, 1,
+                             "Checkpoint file to resume from and write to."));
+  cp.addOption(CommandOption(opt_checkpoint_interval, 1, 1,
+                             "Checkpoint interval in milliseconds."));
+  cp.addOption(CommandOption(opt_results, 1, 1,
+                             "Results file of the sample strategy."));
+  cp.addOption(CommandOption(opt_clock_report, 1, 1,
+                             "Report interval in simulated seconds."));
 
   try {
     Settings settings = parseCmdLine(cp, argc, argv);
 
+    stats::OpenCounters(settings.counters_path);
+    BTX_TRACE_START("subscriber.trace.json");
+    BTX_TRACE_THREAD_NAME("subscriber");
+
     std::cout << "Subscribing to channel " << settings.channel
               << " on Stream ID " << settings.stream_id << std::endl;
 
     auto data_handler = std::make_shared<backtestx::plot::DataHandler>();
+    auto book_store = std::make_shared<backtestx::book::BookStore>();
+
+    // Resume from the latest checkpoint before any data arrives
+    std::unique_ptr<checkpoint::Checkpointer> checkpointer;
+    std::size_t restored = 0;
+    if (!settings.checkpoint_path.empty()) {
+      checkpointer = std::make_unique<checkpoint::Checkpointer>(
+          data_handler, settings.checkpoint_path,
+          std::chrono::milliseconds(settings.checkpoint_interval_ms));
+      std::uint64_t next_row;
+      restored = checkpointer->Restore(next_row);
+      if (restored > 0) {
+        std::cout << "Resumed " << restored << " bars from "
+                  << settings.checkpoint_path
+                  << ", start the publisher with -o " << next_row
+                  << " to skip them" << std::endl;
+      }
+      checkpointer->Start();
+    }
+
+    // Results are appended on the polling thread and written on the writer's.
+    // The file is rewritten from the start even when resuming: the strategy
+    // is deterministic and is replayed over the restored bars, so it records
+    // their results again, and anything a previous run wrote past its last
+    // checkpoint is recorded again as the publisher resends those rows.
+    std::unique_ptr<results::ResultsWriter> results_writer;
+    std::unique_ptr<results::ResultsSink> results_sink;
+    std::shared_ptr<strategy::BarListener> bar_listener;
+    if (!settings.results_path.empty()) {
+      if (restored > 0) {
+        std::cout << "Rebuilding the results of the " << restored
+                  << " restored bars in " << settings.results_path
+                  << std::endl;
+      }
+      results_writer = std::make_unique<results::ResultsWriter>();
+      if (!results_writer->Open(settings.results_path)) {
+        throw std::runtime_error("Failed to open results file " +
+                                 settings.results_path);
+      }
+      results_sink = results_writer->CreateSink();
+      bar_listener = MakeSampleStrategy(results_sink.get());
+    }
+
+    // Bar timestamps drive the simulated clock ahead of the strategy, so
+    // scheduled events run before the first bar at or after their time
+    sim::Scheduler scheduler;
+    if (settings.clock_report_seconds > 0) {
+      bar_listener = std::make_shared<ClockReport>(
+          scheduler, settings.clock_report_seconds * sim::NANOS_PER_SECOND,
+          bar_listener);
+      bar_listener = std::make_shared<sim::BarClock>(scheduler, bar_listener);
+    }
+    // Restored bars are replayed to the listener before live bars arrive
+    if (bar_listener) data_handler->SetBarListener(bar_listener);
 
     // Start GUI thread
     graphical::GUI gui;
     gui.SetDataHandler(data_handler);
+    gui.SetBookStore(book_store);
     gui.StartGUIThread();
 
     aeron::Context context;
@@ -129,14 +318,27 @@ int main(int argc, char** argv) {
                       : std::to_string(channel_status))
               << std::endl;
 
-    FragmentAssembler fragment_assembler(DataPlottingHandler(data_handler));
+    FragmentAssembler fragment_assembler(
+        DataPlottingHandler(data_handler, book_store));
     fragment_handler_t handler = fragment_assembler.handler();
     SleepingIdleStrategy idle_strategy(IDLE_SLEEP_MS);
 
     while (running) {
-      const int fragmentsRead = subscription->poll(handler, FRAGMENTS_LIMIT);
+      int fragmentsRead;
+      {
+        BTX_TRACE_SCOPE("Poll");
+        fragmentsRead = subscription->poll(handler, FRAGMENTS_LIMIT);
+      }
       idle_strategy.idle(fragmentsRead);
     }
+
+    if (checkpointer) checkpointer->Stop();
+    if (bar_listener) data_handler->SetBarListener(nullptr);
+    if (results_writer) {
+      results_sink.reset();
+      results_writer->Close();
+    }
+    BTX_TRACE_STOP();
   } catch (const CommandOptionException& e) {
     std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
     cp.displayOptionsHelp(std::cerr);
@@ -0,0 +1,167 @@
+#include "BackTestX/trace/trace.hpp"
+
+#ifdef BACKTESTX_ENABLE_TRACING
+
+#include <cstdlib>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace backtestx {
+namespace trace {
+
+thread_local ThreadBuffer *t_buffer = nullptr;
+
+namespace {
+
+static const std::chrono::milliseconds FLUSH_POLL_INTERVAL(100);
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+  std::uint32_t next_thread_id = 1;
+
+  std::string path;
+  std::int64_t start_ns = 0;
+  std::thread flusher;
+  std::atomic<bool> running{false};
+};
+
+Registry &GetRegistry() {
+  // Intentionally leaked so buffers outlive threads exiting after main
+  static Registry *registry = new Registry();
+  return *registry;
+}
+
+std::atomic<bool> flush_requested(false);
+
+void SigUsr1Handler(int) { flush_requested = true; }
+
+// Copy the events of a buffer, skipping those the owner overwrites while
+// they are read
+std::vector<Event> Snapshot(const ThreadBuffer &buffer) {
+  const std::uint64_t capacity = ThreadBuffer::CAPACITY;
+  const std::uint64_t head = buffer.head.load(std::memory_order_acquire);
+  const std::uint64_t begin = head > capacity ? head - capacity : 0;
+
+  std::vector<Event> events;
+  events.reserve(head - begin);
+  for (std::uint64_t i = begin; i < head; ++i) {
+    const EventSlot &slot = buffer.slots[i & (capacity - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != i + 1) continue;
+    Event event;
+    event.name = slot.name.load(std::memory_order_relaxed);
+    event.start_ns = slot.start_ns.load(std::memory_order_relaxed);
+    event.duration_ns = slot.duration_ns.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != i + 1) continue;
+    events.push_back(event);
+  }
+  return events;
+}
+
+void WriteTrace(Registry &registry) {
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  if (registry.path.empty()) return;
+
+  const std::string tmp_path = registry.path + ".tmp";
+  std::ofstream file(tmp_path);
+  if (!file.is_open()) {
+    std::cerr << "Failed to open trace file: " << tmp_path << std::endl;
+    return;
+  }
+
+  const long pid = static_cast<long>(::getpid());
+  bool first = true;
+  auto separator = [&file, &first]() {
+    if (!first) file << ",\n";
+    first = false;
+  };
+
+  file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+  char number[64];
+  for (const auto &buffer : registry.buffers) {
+    if (!buffer->thread_name.empty()) {
+      separator();
+      file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+           << ",\"tid\":" << buffer->thread_id << ",\"args\":{\"name\":\""
+           << buffer->thread_name << "\"}}";
+    }
+
+    for (const Event &event : Snapshot(*buffer)) {
+      separator();
+      std::snprintf(number, sizeof(number), "%.3f,\"dur\":%.3f",
+                    (event.start_ns - registry.start_ns) / 1e3,
+                    event.duration_ns / 1e3);
+      file << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"ts\":"
+           << number << ",\"pid\":" << pid << ",\"tid\":" << buffer->thread_id
+           << "}";
+    }
+  }
+  file << "\n]}\n";
+  file.close();
+
+  if (std::rename(tmp_path.c_str(), registry.path.c_str()) != 0) {
+    std::cerr << "Failed to write trace file: " << registry.path << std::endl;
+  }
+}
+
+void FlusherThread() {
+  Registry &registry = GetRegistry();
+  while (registry.running) {
+    std::this_thread::sleep_for(FLUSH_POLL_INTERVAL);
+    if (flush_requested.exchange(false)) WriteTrace(registry);
+  }
+}
+
+}  // namespace
+
+ThreadBuffer *RegisterThread() {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.buffers.push_back(std::make_unique<ThreadBuffer>());
+  ThreadBuffer *buffer = registry.buffers.back().get();
+  buffer->thread_id = registry.next_thread_id++;
+  return buffer;
+}
+
+void SetThreadName(const char *name) {
+  ThreadBuffer &buffer = LocalBuffer();
+  std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+  buffer.thread_name = name;
+}
+
+void Start(const std::string &path) {
+  Registry &registry = GetRegistry();
+  {
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.path = path;
+    registry.start_ns = NowNs();
+  }
+
+  if (!registry.running.exchange(true)) {
+    registry.flusher = std::thread(FlusherThread);
+    signal(SIGUSR1, SigUsr1Handler);
+    static const bool stop_at_exit = std::atexit(Stop) == 0;
+    (void)stop_at_exit;
+  }
+}
+
+void Stop() {
+  Registry &registry = GetRegistry();
+  if (!registry.running.exchange(false)) return;
+  if (registry.flusher.joinable()) registry.flusher.join();
+  WriteTrace(registry);
+}
+
+}  // namespace trace
+}  // namespace backtestx
+
+#endif /* BACKTESTX_ENABLE_TRACING */